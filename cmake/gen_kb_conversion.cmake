@@ -0,0 +1,41 @@
+# Generates name-sorted keyboard conversion table from BINDING() X-macro
+#
+# cmake -DINPUT=src/scancodes/kb_scancodes.h -DOUTPUT=kb_conversion.h -P gen_kb_conversion.cmake
+
+file(STRINGS ${INPUT} lines REGEX "^BINDING\\(")
+
+set(names)
+set(entries)
+foreach(line ${lines})
+  if(NOT line MATCHES "^BINDING\\(([A-Za-z0-9_]+), *(0x[0-9A-Fa-f]+), *\"([A-Za-z0-9_]+)\"\\)")
+    message(FATAL_ERROR "Can't parse '${line}'")
+  endif()
+  set(sc ${CMAKE_MATCH_1})
+  set(name ${CMAKE_MATCH_3})
+  # first binding wins, e.g. for KB_RESERVED
+  list(FIND names ${name} found)
+  if(found EQUAL -1)
+    list(APPEND names ${name})
+    # '!' sorts before any name character, so order matches strcmp
+    list(APPEND entries "${name}!${sc}")
+  endif()
+endforeach()
+
+list(SORT entries)
+
+set(content "// generated from kb_scancodes.h by gen_kb_conversion.cmake, do not edit\n")
+foreach(entry ${entries})
+  string(REPLACE "!" ";" pair ${entry})
+  list(GET pair 0 name)
+  list(GET pair 1 sc)
+  set(content "${content}{\"${name}\", ${sc}},\n")
+endforeach()
+
+# don't touch output if nothing changed, to avoid needless rebuilds
+if(EXISTS ${OUTPUT})
+  file(READ ${OUTPUT} old)
+  if(old STREQUAL content)
+    return()
+  endif()
+endif()
+file(WRITE ${OUTPUT} "${content}")
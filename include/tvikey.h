@@ -0,0 +1,92 @@
+#ifndef __TVIKEY_H__
+#define __TVIKEY_H__
+
+// User API of tvikey.skprx, link with libtvikey_stub.a
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TVIKEY_ERROR_INVALID_BINDINGS -2
+#define TVIKEY_ERROR_NO_MEMORY -3
+#define TVIKEY_ERROR_SIZE_MISMATCH -4 // caller was built against different tvikey.h
+
+#define TVIKEY_LIST 0x80             // bound value with this bit set is offset of action list in lists
+#define TVIKEY_LIST_MAX 4            // vita inputs in one list
+#define TVIKEY_LAYERS 3              // base layer and alternate keyboard layers 1..2
+#define TVIKEY_COMBO_KEYS 4          // keys in sequence, chords have up to 3
+#define TVIKEY_COMBO_WINDOW 250      // ms between sequence presses, if bindings don't set it
+#define TVIKEY_MOUSE_FILTER_MAX 1000 // ms, longest mouse smoothing and decay
+#define TVIKEY_COMBOS 32             // chords and sequences per bindings
+
+typedef struct
+{
+  uint8_t keys[TVIKEY_COMBO_KEYS]; // usb hid scancodes, sorted for chords, in press order for sequences, 0 padded
+  uint8_t sequence;                // keys are pressed one after another instead of held together
+  uint8_t value;                   // bound vita input or list, 0 for unused slot
+} tvikey_combo_t;
+
+// Bound values are vita buttons/directions, same as in tvikey.ini, 0 is unbound.
+typedef struct
+{
+  uint32_t size;       // sizeof(tvikey_bindings_t), set by caller before tvikeyGetBindings/tvikeySetBindings
+  uint8_t kb[256];     // by usb hid keyboard scancode
+  uint8_t kb_mod[8];   // by modifier bit
+  uint8_t mouse[8];    // buttons 1-3, then -x, +x, -y, +y
+  int16_t mouse_sensitivity_x; // Q8.8, negative inverts axis
+  int16_t mouse_sensitivity_y;
+  uint8_t lists[128];  // zero terminated lists of vita inputs, for inputs bound to several at once
+  uint8_t layers[TVIKEY_LAYERS - 1][256];  // kb of layers 1.., unbound keys use kb
+  uint8_t layer_hold[TVIKEY_LAYERS - 1];   // usb hid scancode enabling layer while held, modifiers are 0xE0-0xE7
+  uint8_t layer_toggle[TVIKEY_LAYERS - 1]; // usb hid scancode switching layer on and off
+  tvikey_combo_t combos[TVIKEY_COMBOS];
+  uint16_t combo_window; // ms between sequence presses, 0 for TVIKEY_COMBO_WINDOW
+  // mouse response curve, all 0 for plain delta * sensitivity
+  uint16_t curve_exponent;     // Q8.8, 0 for 1.0
+  uint8_t curve_anti_deadzone; // % of stick range added to any movement
+  uint8_t curve_max_speed;     // movement after sensitivity giving full deflection, 0 for stick range
+  uint8_t curve_acceleration;  // % of extra gain at full speed
+  // stick movement over time, 0 follows mouse as is
+  uint16_t mouse_smoothing; // ms, time constant of averaging movement
+  uint16_t mouse_decay;     // ms for movement to fade out after last report
+} tvikey_bindings_t;
+
+typedef struct
+{
+  uint32_t arena_size; // bytes reserved for config state
+  uint32_t arena_used;
+  uint32_t arena_peak;
+  uint32_t arena_failures; // allocations refused because budget was full
+  uint32_t loader_stack_size;
+  uint32_t loader_stack_peak;
+} tvikey_memory_stats_t;
+
+typedef struct
+{
+  uint32_t reports_processed; // usb reports decoded into input
+  uint32_t reports_skipped;   // repeats of last report, not decoded
+} tvikey_input_stats_t;
+
+// Copy currently active bindings, bindings->size has to be set
+int tvikeyGetBindings(tvikey_bindings_t *bindings);
+
+// Activate bindings for calling process, they stay until process exits,
+// tvikeyResetBindings is called or tvikey.ini is changed, bindings->size has to be set
+int tvikeySetBindings(const tvikey_bindings_t *bindings);
+
+// Go back to bindings from tvikey.ini
+int tvikeyResetBindings();
+
+// Memory used by driver for config state
+int tvikeyGetMemoryStats(tvikey_memory_stats_t *stats);
+
+// Report counters of all attached devices since driver start
+int tvikeyGetInputStats(tvikey_input_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TVIKEY_H__
@@ -0,0 +1,86 @@
+#include "actions.h"
+
+#include "scancodes/scancodes.h"
+
+#include <psp2kern/ctrl.h>
+#include <psp2kern/kernel/sysclib.h>
+
+#define BUTTON(sc, mask) [sc] = {(mask), AXIS_NONE, 0}
+#define AXIS(sc, axis, value) [sc] = {0, (axis), (value)}
+
+// Every entry starts as no-op through range default, listed ones then override it.
+// That override is the point here, so -Woverride-init (part of -Wextra) is off for this table.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverride-init"
+
+// unbound (0) and anything else not listed does nothing
+const action_t actions[256] = {
+    [0 ... 255] = {0, AXIS_NONE, 0},
+
+    BUTTON(V_SCANCODE_DUP, SCE_CTRL_UP),
+    BUTTON(V_SCANCODE_DDOWN, SCE_CTRL_DOWN),
+    BUTTON(V_SCANCODE_DLEFT, SCE_CTRL_LEFT),
+    BUTTON(V_SCANCODE_DRIGHT, SCE_CTRL_RIGHT),
+
+    BUTTON(V_SCANCODE_CROSS, SCE_CTRL_CROSS),
+    BUTTON(V_SCANCODE_CIRCLE, SCE_CTRL_CIRCLE),
+    BUTTON(V_SCANCODE_TRIANGLE, SCE_CTRL_TRIANGLE),
+    BUTTON(V_SCANCODE_SQUARE, SCE_CTRL_SQUARE),
+
+    BUTTON(V_SCANCODE_L1, SCE_CTRL_L1),
+    BUTTON(V_SCANCODE_R1, SCE_CTRL_R1),
+    BUTTON(V_SCANCODE_L3, SCE_CTRL_L3),
+    BUTTON(V_SCANCODE_R3, SCE_CTRL_R3),
+
+    [V_SCANCODE_L2] = {SCE_CTRL_LTRIGGER, AXIS_LT, 0xFF},
+    [V_SCANCODE_R2] = {SCE_CTRL_RTRIGGER, AXIS_RT, 0xFF},
+
+    AXIS(V_SCANCODE_LXM, AXIS_LX, 0),
+    AXIS(V_SCANCODE_LXP, AXIS_LX, 255),
+    AXIS(V_SCANCODE_LYM, AXIS_LY, 0),
+    AXIS(V_SCANCODE_LYP, AXIS_LY, 255),
+    AXIS(V_SCANCODE_RXM, AXIS_RX, 0),
+    AXIS(V_SCANCODE_RXP, AXIS_RX, 255),
+    AXIS(V_SCANCODE_RYM, AXIS_RY, 0),
+    AXIS(V_SCANCODE_RYP, AXIS_RY, 255),
+
+    BUTTON(V_SCANCODE_PS, SCE_CTRL_PSBUTTON),
+    BUTTON(V_SCANCODE_START, SCE_CTRL_START),
+    BUTTON(V_SCANCODE_SELECT, SCE_CTRL_SELECT),
+};
+
+#pragma GCC diagnostic pop
+
+void bindings_compile(const bindings_t *b, compiled_bindings_t *c)
+{
+  memset(c, 0, sizeof(compiled_bindings_t));
+
+  for (int i = 0; i < 8; i++)
+  {
+    uint8_t bind  = b->kb_mod[i];
+    uint32_t mask = actions[bind].buttons;
+    int axis      = actions[bind].axis != AXIS_NONE;
+
+    if (bind & TVIKEY_LIST)
+    {
+      for (const uint8_t *l = &b->lists[bind & ~TVIKEY_LIST]; *l; l++)
+      {
+        mask |= actions[*l].buttons;
+        axis |= actions[*l].axis != AXIS_NONE;
+      }
+    }
+
+    if (axis)
+      c->mod_axes |= 1 << i;
+
+    // every nibble value that has bit i set gets its buttons
+    for (int n = 0; n < 16; n++)
+    {
+      if (n & (1 << (i & 3)))
+        c->mod_buttons[i >> 2][n] |= mask;
+    }
+  }
+
+  combos_compile(b, &c->combos);
+  mouse_curve_compile(b, c->mouse_lut);
+}
@@ -0,0 +1,44 @@
+#ifndef __ACTIONS_H__
+#define __ACTIONS_H__
+
+#include "combos.h"
+#include "config.h"
+#include "curves.h"
+
+#include <stdint.h>
+
+// What bound vita input does to controller state, indexed by VitaScancode
+
+enum
+{
+  AXIS_LX,
+  AXIS_LY,
+  AXIS_RX,
+  AXIS_RY,
+  AXIS_LT,
+  AXIS_RT,
+  AXIS_NONE, // dummy axis, keeps applying actions branch free
+  AXIS_COUNT
+};
+
+typedef struct
+{
+  uint32_t buttons; // SCE_CTRL_* to set
+  uint8_t axis;
+  uint8_t value; // written to axis when input is digital
+} action_t;
+
+extern const action_t actions[256];
+
+// Per profile data derived from bindings once, when profile is created
+typedef struct
+{
+  uint32_t mod_buttons[2][16]; // buttons for low and high nibble of modifier byte
+  uint8_t mod_axes;            // modifiers bound to something with axis
+  compiled_combos_t combos;
+  uint8_t mouse_lut[256];      // stick position by mouse movement after sensitivity
+} compiled_bindings_t;
+
+void bindings_compile(const bindings_t *b, compiled_bindings_t *c);
+
+#endif // __ACTIONS_H__
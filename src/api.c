@@ -0,0 +1,37 @@
+#include "api.h"
+
+#include <psp2kern/kernel/sysmem.h>
+
+static int check_size(const tvikey_bindings_t *user)
+{
+  uint32_t size;
+  int ret = ksceKernelMemcpyUserToKernel(&size, &user->size, sizeof(size));
+  if (ret < 0)
+    return ret;
+  return size == sizeof(bindings_t) ? 0 : TVIKEY_ERROR_SIZE_MISMATCH;
+}
+
+int api_bindings_from_user(bindings_t *b, const tvikey_bindings_t *user)
+{
+  int ret = check_size(user);
+  if (ret < 0)
+    return ret;
+
+  ret = ksceKernelMemcpyUserToKernel(b, user, sizeof(bindings_t));
+  if (ret < 0)
+    return ret;
+
+  // user may have changed it in between, profiles compare whole struct
+  b->size = sizeof(bindings_t);
+  return bindings_validate(b) ? 0 : TVIKEY_ERROR_INVALID_BINDINGS;
+}
+
+int api_bindings_to_user(tvikey_bindings_t *user, const bindings_t *b)
+{
+  int ret = check_size(user);
+  if (ret < 0)
+    return ret;
+
+  ret = ksceKernelMemcpyKernelToUser(user, b, sizeof(bindings_t));
+  return ret < 0 ? ret : 0;
+}
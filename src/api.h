@@ -0,0 +1,15 @@
+#ifndef __API_H__
+#define __API_H__
+
+#include "config.h"
+
+// Copying bindings across syscall boundary, shared by tvikeyGetBindings and tvikeySetBindings.
+// Both check size field of user copy first, so app built against other tvikey.h gets
+// TVIKEY_ERROR_SIZE_MISMATCH instead of reading or writing past its struct.
+
+// copy user bindings into b, returns 0 or error if they can't be copied, don't match or fail validation
+int api_bindings_from_user(bindings_t *b, const tvikey_bindings_t *user);
+// copy b out to user, returns 0 or error
+int api_bindings_to_user(tvikey_bindings_t *user, const bindings_t *b);
+
+#endif // __API_H__
@@ -0,0 +1,124 @@
+#include "arena.h"
+
+#include "cache.h"
+#include "profile.h"
+
+#include <psp2kern/kernel/debug.h>
+#include <psp2kern/kernel/sysclib.h>
+#include <psp2kern/kernel/sysmem.h>
+
+#define ARENA_ALIGN 8
+#define ALIGN_UP(x) (((x) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+typedef struct
+{
+  uint8_t *base;
+  arena_usage_t usage;
+} budget_t;
+
+static budget_t budgets[ARENA_BUDGETS];
+static SceUID arena_uid = -1;
+
+static const char *budget_names[ARENA_BUDGETS] = {"profiles", "cache", "scratch", "ini index", "bin index"};
+
+int arena_init()
+{
+  SceSize fixed[ARENA_BUDGETS] = {
+      [ARENA_PROFILES] = ALIGN_UP(TVIKEY_MAX_PROFILES * sizeof(profile_t)),
+      [ARENA_CACHE]    = ALIGN_UP(TVIKEY_CACHE_SIZE * sizeof(cache_entry_t)),
+      [ARENA_SCRATCH]  = ALIGN_UP(sizeof(bindings_t)),
+  };
+
+  SceSize size  = (TVIKEY_ARENA_SIZE + 0xFFF) & ~0xFFF;
+  SceSize taken = fixed[ARENA_PROFILES] + fixed[ARENA_CACHE] + fixed[ARENA_SCRATCH];
+  SceSize rest  = size - taken;
+  if (taken > size)
+  {
+    ksceDebugPrintf("Arena of %u bytes can't fit profiles, cache and scratch\n", size);
+    return -1;
+  }
+
+  fixed[ARENA_INI_INDEX] = (rest / 2) & ~(ARENA_ALIGN - 1);
+  fixed[ARENA_BIN_INDEX] = rest - fixed[ARENA_INI_INDEX];
+
+  arena_uid = ksceKernelAllocMemBlock("tvikey_arena", SCE_KERNEL_MEMBLOCK_TYPE_KERNEL_RW, size, NULL);
+  if (arena_uid < 0)
+    return arena_uid;
+
+  uint8_t *base;
+  ksceKernelGetMemBlockBase(arena_uid, (void **)&base);
+
+  for (int i = 0; i < ARENA_BUDGETS; i++)
+  {
+    memset(&budgets[i], 0, sizeof(budget_t));
+    budgets[i].base       = base;
+    budgets[i].usage.size = fixed[i];
+    base += fixed[i];
+  }
+
+  return 0;
+}
+
+void arena_term()
+{
+  if (arena_uid >= 0)
+    ksceKernelFreeMemBlock(arena_uid);
+  arena_uid = -1;
+  memset(budgets, 0, sizeof(budgets));
+}
+
+void *arena_alloc(arena_budget budget, SceSize size)
+{
+  budget_t *b = &budgets[budget];
+  size        = ALIGN_UP(size);
+
+  if (!b->base || size > b->usage.size - b->usage.used)
+  {
+    b->usage.failures++;
+    ksceDebugPrintf("Arena budget '%s' exhausted: %u of %u bytes used, %u requested\n", budget_names[budget],
+                    b->usage.used, b->usage.size, size);
+    return NULL;
+  }
+
+  void *p = b->base + b->usage.used;
+  b->usage.used += size;
+  if (b->usage.used > b->usage.peak)
+    b->usage.peak = b->usage.used;
+
+  memset(p, 0, size);
+  return p;
+}
+
+void arena_reset(arena_budget budget)
+{
+  budgets[budget].usage.used = 0;
+}
+
+void arena_usage(arena_budget budget, arena_usage_t *usage)
+{
+  if (budget < ARENA_BUDGETS)
+  {
+    memcpy(usage, &budgets[budget].usage, sizeof(arena_usage_t));
+    return;
+  }
+
+  // peak is sum of budget peaks, upper bound of real one
+  memset(usage, 0, sizeof(arena_usage_t));
+  for (int i = 0; i < ARENA_BUDGETS; i++)
+  {
+    usage->size += budgets[i].usage.size;
+    usage->used += budgets[i].usage.used;
+    usage->peak += budgets[i].usage.peak;
+    usage->failures += budgets[i].usage.failures;
+  }
+}
+
+void arena_report()
+{
+  for (int i = 0; i < ARENA_BUDGETS; i++)
+  {
+    arena_usage_t *u = &budgets[i].usage;
+    ksceDebugPrintf("Arena '%s': %u/%u bytes, peak %u, %u failures\n", budget_names[i], u->used, u->size, u->peak,
+                    u->failures);
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <psp2common/types.h>
+
+// All config state lives in one memblock of TVIKEY_ARENA_SIZE bytes.
+// Every user gets fixed budget inside it, allocation past budget fails instead of growing.
+
+#ifndef TVIKEY_ARENA_SIZE
+#define TVIKEY_ARENA_SIZE 0x18000
+#endif
+
+typedef enum
+{
+  ARENA_PROFILES,
+  ARENA_CACHE,
+  ARENA_SCRATCH,   // one bindings_t for syscalls
+  ARENA_INI_INDEX, // section indexes split what's left
+  ARENA_BIN_INDEX,
+  ARENA_BUDGETS
+} arena_budget;
+
+typedef struct
+{
+  SceSize size;
+  SceSize used;
+  SceSize peak;
+  uint32_t failures;
+} arena_usage_t;
+
+int arena_init();
+// give memblock back, nothing allocated from arena may be used afterwards
+void arena_term();
+
+// zeroed memory from budget, NULL if budget is exhausted
+void *arena_alloc(arena_budget budget, SceSize size);
+// free everything allocated from budget
+void arena_reset(arena_budget budget);
+
+// budget == ARENA_BUDGETS gives totals
+void arena_usage(arena_budget budget, arena_usage_t *usage);
+void arena_report();
+
+#endif // __ARENA_H__
@@ -0,0 +1,176 @@
+#include "binconfig.h"
+
+#include "arena.h"
+#include "util/iostat.h"
+#include "util/trie.h"
+
+#include <psp2kern/io/fcntl.h>
+#include <psp2kern/io/stat.h>
+#include <psp2kern/kernel/debug.h>
+#include <psp2kern/kernel/sysclib.h>
+
+static binconfig_header_t header;
+static binconfig_index_t *titles;
+static binconfig_index_t *patterns;
+static trie_t trie;
+static SceIoStat titles_stat; // blob stat at the moment index was cached
+
+static void drop_index()
+{
+  arena_reset(ARENA_BIN_INDEX);
+  titles   = NULL;
+  patterns = NULL;
+}
+
+static int load_patterns(SceUID fd)
+{
+  SceSize size = header.pattern_count * sizeof(binconfig_index_t);
+  patterns     = arena_alloc(ARENA_BIN_INDEX, size);
+  if (!patterns)
+    return -1;
+
+  if (ksceIoLseek(fd, header.patterns_offset, SCE_SEEK_SET) < 0 || ksceIoRead(fd, patterns, size) != (int)size)
+    return -1;
+
+  int nodes = 1;
+  for (uint32_t i = 0; i < header.pattern_count; i++)
+  {
+    patterns[i].titleid[sizeof(patterns[i].titleid) - 1] = '\0';
+    nodes += trie_nodes_needed(patterns[i].titleid);
+  }
+
+  trie_node_t *n = arena_alloc(ARENA_BIN_INDEX, nodes * sizeof(trie_node_t));
+  if (!n)
+    return -1;
+
+  trie_init(&trie, n, nodes);
+  for (uint32_t i = 0; i < header.pattern_count; i++)
+  {
+    if (trie_insert(&trie, patterns[i].titleid, i) < 0)
+      return -1;
+  }
+
+  return 0;
+}
+
+static int load_index(const SceIoStat *st)
+{
+  drop_index();
+
+  SceUID fd = ksceIoOpen(CONFIG_BIN_PATH, SCE_O_RDONLY, 0);
+  if (fd < 0)
+    return fd;
+
+  int ret = -1;
+
+  if (ksceIoRead(fd, &header, sizeof(header)) != sizeof(header))
+    goto out;
+
+  if (header.magic != BINCONFIG_MAGIC || header.version != BINCONFIG_VERSION
+      || header.record_size != sizeof(bindings_t) || header.count + header.pattern_count == 0
+      || header.count > BINCONFIG_MAX_TITLES || header.pattern_count > BINCONFIG_MAX_TITLES)
+  {
+    ksceDebugPrintf("'%s' is invalid or outdated, ignoring\n", CONFIG_BIN_PATH);
+    goto out;
+  }
+
+  SceSize size = header.count * sizeof(binconfig_index_t);
+  titles       = arena_alloc(ARENA_BIN_INDEX, size);
+  if (!titles)
+    goto out;
+
+  if (ksceIoLseek(fd, header.index_offset, SCE_SEEK_SET) < 0 || ksceIoRead(fd, titles, size) != (int)size)
+  {
+    drop_index();
+    goto out;
+  }
+
+  if (header.pattern_count && load_patterns(fd) < 0)
+  {
+    drop_index();
+    goto out;
+  }
+
+  memcpy(&titles_stat, st, sizeof(SceIoStat));
+  ret = 0;
+
+out:
+  ksceIoClose(fd);
+  return ret;
+}
+
+// plain section beats any pattern
+static const binconfig_index_t *find_title(const char *titleid)
+{
+  int lo = 0;
+  int hi = header.count - 1;
+
+  while (lo <= hi)
+  {
+    int mid = (lo + hi) / 2;
+    int cmp = strncmp(titleid, titles[mid].titleid, sizeof(titles[mid].titleid));
+    if (cmp == 0)
+      return &titles[mid];
+    if (cmp < 0)
+      hi = mid - 1;
+    else
+      lo = mid + 1;
+  }
+
+  if (patterns)
+  {
+    int32_t i = trie_find(&trie, titleid);
+    if (i >= 0)
+      return &patterns[i];
+  }
+
+  return NULL;
+}
+
+int binconfig_load(const char *titleid, bindings_t *b)
+{
+  SceIoStat bin_st;
+  SceIoStat ini_st;
+
+  int ret = ksceIoGetstat(CONFIG_BIN_PATH, &bin_st);
+  if (ret < 0)
+  {
+    drop_index();
+    return ret;
+  }
+
+  int have_ini = (ksceIoGetstat(CONFIG_INI_PATH, &ini_st) >= 0);
+
+  // ini was edited after blob was compiled
+  if (have_ini && datetime_cmp(&ini_st.st_mtime, &bin_st.st_mtime) > 0)
+    return -1;
+
+  if (!titles || !iostat_same(&titles_stat, &bin_st))
+  {
+    ret = load_index(&bin_st);
+    if (ret < 0)
+      return ret;
+  }
+
+  if (have_ini && ini_st.st_size != header.ini_size)
+    return -1;
+
+  const binconfig_index_t *t = find_title(titleid);
+  if (!t || t->record == BINCONFIG_NO_RECORD)
+    return 0;
+
+  SceUID fd = ksceIoOpen(CONFIG_BIN_PATH, SCE_O_RDONLY, 0);
+  if (fd < 0)
+    return fd;
+
+  ret = -1;
+  if (ksceIoLseek(fd, header.records_offset + t->record * header.record_size, SCE_SEEK_SET) >= 0
+      && ksceIoRead(fd, b, sizeof(bindings_t)) == sizeof(bindings_t))
+  {
+    // broken list would send input callback past end of lists
+    ret = bindings_validate(b) ? 1 : -1;
+  }
+
+  ksceIoClose(fd);
+  return ret;
+}
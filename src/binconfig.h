@@ -0,0 +1,45 @@
+#ifndef __BINCONFIG_H__
+#define __BINCONFIG_H__
+
+#include "config.h"
+
+#include <stdint.h>
+
+// Precompiled tvikey.ini, produced by tools/tvikeyc
+//
+// layout (little-endian):
+//   binconfig_header_t
+//   binconfig_index_t[count], sorted by titleid
+//   binconfig_index_t[pattern_count], wildcard sections in ini order
+//   bindings_t records, possibly shared by several titles
+
+#define BINCONFIG_MAGIC 0x424B5654 // "TVKB"
+#define BINCONFIG_VERSION 9
+#define BINCONFIG_MAX_TITLES 4096
+#define BINCONFIG_NO_RECORD 0xFFFFFFFF // section without bindings
+
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size; // sizeof(bindings_t) at compile time
+  uint32_t count;       // index entries
+  uint32_t ini_size;    // size of tvikey.ini blob was compiled from
+  uint32_t index_offset;
+  uint32_t records_offset;
+  uint32_t pattern_count;
+  uint32_t patterns_offset;
+} binconfig_header_t;
+
+typedef struct
+{
+  char titleid[16];
+  uint32_t record;
+} binconfig_index_t;
+
+// load bindings of most specific section for titleid from CONFIG_BIN_PATH
+// returns 1 if loaded, 0 if there's no such title,
+// < 0 if blob is missing, invalid or older than tvikey.ini
+int binconfig_load(const char *titleid, bindings_t *b);
+
+#endif // __BINCONFIG_H__
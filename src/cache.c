@@ -0,0 +1,81 @@
+#include "cache.h"
+
+#include "arena.h"
+#include "profile.h"
+
+#include <psp2kern/kernel/debug.h>
+#include <psp2kern/kernel/sysclib.h>
+
+static cache_entry_t *entries;
+static uint32_t tick;
+static uint32_t hits;
+static uint32_t misses;
+
+void cache_init()
+{
+  entries = arena_alloc(ARENA_CACHE, TVIKEY_CACHE_SIZE * sizeof(cache_entry_t));
+}
+
+int cache_get(configuration *config)
+{
+  if (!entries)
+    return 0;
+
+  for (int i = 0; i < TVIKEY_CACHE_SIZE; i++)
+  {
+    if (entries[i].last_used && strncmp(entries[i].titleid, config->titleid, sizeof(config->titleid)) == 0)
+    {
+      entries[i].last_used = ++tick;
+      config->loaded       = entries[i].profile != NULL;
+      if (config->loaded)
+        memcpy(&config->b, &entries[i].profile->b, sizeof(bindings_t));
+      else
+        bindings_clear(&config->b);
+      hits++;
+      ksceDebugPrintf("Cache hit for %s (%u hits, %u misses)\n", config->titleid, hits, misses);
+      return 1;
+    }
+  }
+
+  misses++;
+  return 0;
+}
+
+void cache_put(const configuration *config)
+{
+  if (!entries)
+    return;
+
+  cache_entry_t *victim = &entries[0];
+
+  for (int i = 0; i < TVIKEY_CACHE_SIZE; i++)
+  {
+    if (entries[i].last_used < victim->last_used)
+      victim = &entries[i];
+  }
+
+  profile_t *p = NULL;
+  // not caching is fine if there's no room for profile
+  if (config->loaded && !(p = profile_intern(&config->b)))
+    return;
+
+  if (victim->profile)
+    profile_unref(victim->profile);
+
+  strncpy(victim->titleid, config->titleid, sizeof(victim->titleid));
+  victim->profile   = p;
+  victim->last_used = ++tick;
+}
+
+void cache_clear()
+{
+  if (!entries)
+    return;
+
+  for (int i = 0; i < TVIKEY_CACHE_SIZE; i++)
+  {
+    if (entries[i].profile)
+      profile_unref(entries[i].profile);
+  }
+  memset(entries, 0, TVIKEY_CACHE_SIZE * sizeof(cache_entry_t));
+}
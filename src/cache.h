@@ -0,0 +1,29 @@
+#ifndef __CACHE_H__
+#define __CACHE_H__
+
+#include "config.h"
+
+// LRU cache of loaded configs by titleid, including titles without config.
+// Bindings are kept as shared profiles, so titles with same layout take one copy.
+
+#ifndef TVIKEY_CACHE_SIZE
+#define TVIKEY_CACHE_SIZE 8
+#endif
+
+typedef struct
+{
+  uint32_t last_used; // 0 for free entry
+  char titleid[16];
+  struct profile *profile; // NULL for title without config
+} cache_entry_t;
+
+// takes entries from arena, without them nothing is cached
+void cache_init();
+
+// returns 1 and fills config->loaded and config->b on hit
+int cache_get(configuration *config);
+void cache_put(const configuration *config);
+// drop everything, e.g. when config file changed
+void cache_clear();
+
+#endif // __CACHE_H__
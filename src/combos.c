@@ -0,0 +1,191 @@
+#include "combos.h"
+
+#include <psp2kern/kernel/sysclib.h>
+
+#define KEY_BIT(key) (0x80000000u >> ((key) & 31))
+#define COMBO_HELD_MAX (64 - 2 + 8) // every key slot of 64 byte report and 8 modifiers
+
+static int has_key(const uint32_t *keys, uint8_t key)
+{
+  return (keys[key >> 5] & KEY_BIT(key)) != 0;
+}
+
+static uint32_t hash(const uint8_t *keys, uint8_t sequence)
+{
+  uint32_t h = 2166136261u ^ sequence;
+  for (int i = 0; i < TVIKEY_COMBO_KEYS; i++)
+  {
+    h ^= keys[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static int combo_keys(const tvikey_combo_t *combo)
+{
+  int n = 0;
+  while (n < TVIKEY_COMBO_KEYS && combo->keys[n])
+    n++;
+  return n;
+}
+
+// keys must be 0 padded to TVIKEY_COMBO_KEYS
+static int lookup(const bindings_t *b, const compiled_combos_t *c, const uint8_t *keys, uint8_t sequence)
+{
+  for (uint32_t i = hash(keys, sequence) & (COMBO_TABLE_SIZE - 1);; i = (i + 1) & (COMBO_TABLE_SIZE - 1))
+  {
+    if (!c->table[i])
+      return 0;
+
+    const tvikey_combo_t *combo = &b->combos[c->table[i] - 1];
+    if (combo->sequence == sequence && memcmp(combo->keys, keys, TVIKEY_COMBO_KEYS) == 0)
+      return c->table[i];
+  }
+}
+
+void combos_compile(const bindings_t *b, compiled_combos_t *c)
+{
+  memset(c, 0, sizeof(compiled_combos_t));
+
+  for (int n = 0; n < TVIKEY_COMBOS; n++)
+  {
+    const tvikey_combo_t *combo = &b->combos[n];
+    int count                   = combo_keys(combo);
+    if (!combo->value || count < 2 || (!combo->sequence && count > 3))
+      continue;
+
+    // first one wins, same as with sections
+    if (lookup(b, c, combo->keys, combo->sequence))
+      continue;
+
+    uint32_t i = hash(combo->keys, combo->sequence) & (COMBO_TABLE_SIZE - 1);
+    while (c->table[i])
+      i = (i + 1) & (COMBO_TABLE_SIZE - 1);
+    c->table[i] = n + 1;
+
+    for (int k = 0; k < count; k++)
+      c->keys[combo->keys[k] >> 5] |= KEY_BIT(combo->keys[k]);
+  }
+}
+
+void combo_reset(combo_state_t *s)
+{
+  memset(s, 0, sizeof(combo_state_t));
+}
+
+static void sort3(uint8_t *k)
+{
+  uint8_t t;
+  if (k[0] > k[1])
+    t = k[0], k[0] = k[1], k[1] = t;
+  if (k[1] > k[2])
+    t = k[1], k[1] = k[2], k[2] = t;
+  if (k[0] > k[1])
+    t = k[0], k[0] = k[1], k[1] = t;
+}
+
+// chord of key and up to two other held keys, bigger chords first
+static int find_chord(const bindings_t *b, const compiled_combos_t *c, const keystate_t *keys, uint8_t key)
+{
+  uint8_t held[COMBO_HELD_MAX];
+  int count = 0;
+
+  // only keys that are part of some combo can complete one
+  for (int w = 0; w < 8 && count < COMBO_HELD_MAX; w++)
+  {
+    uint32_t m = keys->keys[w] & c->keys[w];
+    while (m && count < COMBO_HELD_MAX)
+    {
+      int bit = __builtin_clz(m);
+      m &= ~(0x80000000u >> bit);
+      if (((w << 5) | bit) != key)
+        held[count++] = (w << 5) | bit;
+    }
+  }
+
+  uint8_t k[TVIKEY_COMBO_KEYS] = {0};
+  int found;
+
+  for (int i = 0; i < count; i++)
+  {
+    for (int j = i + 1; j < count; j++)
+    {
+      k[0] = key, k[1] = held[i], k[2] = held[j];
+      sort3(k);
+      if ((found = lookup(b, c, k, 0)))
+        return found;
+    }
+  }
+
+  k[2] = 0;
+  for (int i = 0; i < count; i++)
+  {
+    k[0] = key < held[i] ? key : held[i];
+    k[1] = key < held[i] ? held[i] : key;
+    if ((found = lookup(b, c, k, 0)))
+      return found;
+  }
+
+  return 0;
+}
+
+// longest sequence ending with recent presses
+static int find_sequence(const bindings_t *b, const compiled_combos_t *c, const combo_state_t *s)
+{
+  for (int len = s->history_len; len >= 2; len--)
+  {
+    uint8_t k[TVIKEY_COMBO_KEYS] = {0};
+    memcpy(k, &s->history[s->history_len - len], len);
+
+    int found = lookup(b, c, k, 1);
+    if (found)
+      return found;
+  }
+  return 0;
+}
+
+void combo_press(combo_state_t *s, const bindings_t *b, const compiled_combos_t *c, const keystate_t *keys,
+                 uint8_t key, SceUInt64 now)
+{
+  SceUInt64 window = (b->combo_window ? b->combo_window : TVIKEY_COMBO_WINDOW) * 1000ull;
+
+  // any other key or a pause breaks a sequence
+  if (!has_key(c->keys, key) || now - s->last_press > window)
+    s->history_len = 0;
+  s->last_press = now;
+
+  if (!has_key(c->keys, key))
+    return;
+
+  if (s->history_len == TVIKEY_COMBO_KEYS)
+  {
+    memmove(s->history, s->history + 1, TVIKEY_COMBO_KEYS - 1);
+    s->history_len--;
+  }
+  s->history[s->history_len++] = key;
+
+  int found = find_sequence(b, c, s);
+  if (!found)
+    found = find_chord(b, c, keys, key);
+  if (found)
+    s->active = found;
+}
+
+const tvikey_combo_t *combo_active(combo_state_t *s, const bindings_t *b, const keystate_t *keys)
+{
+  if (!s->active)
+    return NULL;
+
+  // chord lasts while all its keys are held, sequence while its last key is
+  const tvikey_combo_t *combo = &b->combos[s->active - 1];
+  int count                   = combo_keys(combo);
+  for (int i = combo->sequence ? count - 1 : 0; i < count; i++)
+  {
+    if (!keystate_pressed(keys, combo->keys[i]))
+    {
+      s->active = 0;
+      return NULL;
+    }
+  }
+  return combo;
+}
@@ -0,0 +1,58 @@
+#ifndef __COMBOS_H__
+#define __COMBOS_H__
+
+#include "config.h"
+#include "keystate.h"
+
+#include <psp2common/types.h>
+#include <stdint.h>
+
+// Chords (keys held together) and sequences (keys pressed one after another).
+// Combos of a profile are compiled into a hash table keyed by their keys, so press of a key
+// costs a few lookups built from keys held and pressed recently, however many combos there are.
+
+#define COMBO_TABLE_SIZE (TVIKEY_COMBOS * 2) // power of two, kept at most half full
+
+typedef struct
+{
+  uint8_t table[COMBO_TABLE_SIZE]; // combo index + 1, 0 for free slot
+  uint32_t keys[8];                // keys used by any combo, same bit order as keystate_t
+} compiled_combos_t;
+
+typedef struct
+{
+  uint8_t active; // combo index + 1, 0 if none
+  uint8_t history[TVIKEY_COMBO_KEYS];
+  uint8_t history_len;
+  SceUInt64 last_press; // us
+} combo_state_t;
+
+void combos_compile(const bindings_t *b, compiled_combos_t *c);
+
+void combo_reset(combo_state_t *s);
+
+// feed press of key at time now, starts combo it completes
+void combo_press(combo_state_t *s, const bindings_t *b, const compiled_combos_t *c, const keystate_t *keys,
+                 uint8_t key, SceUInt64 now);
+
+// active combo, or NULL if none or its keys were released
+const tvikey_combo_t *combo_active(combo_state_t *s, const bindings_t *b, const keystate_t *keys);
+
+static inline int combo_uses(const tvikey_combo_t *combo, uint8_t key)
+{
+  return combo->keys[0] == key || combo->keys[1] == key || combo->keys[2] == key || combo->keys[3] == key;
+}
+
+// modifier bits of report that are keys of combo
+static inline uint8_t combo_mods(const tvikey_combo_t *combo)
+{
+  uint8_t mods = 0;
+  for (int i = 0; i < TVIKEY_COMBO_KEYS; i++)
+  {
+    if (combo->keys[i] >= KEY_LEFT_CTRL && combo->keys[i] < KEY_LEFT_CTRL + 8)
+      mods |= 1 << (combo->keys[i] - KEY_LEFT_CTRL);
+  }
+  return mods;
+}
+
+#endif // __COMBOS_H__
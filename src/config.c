@@ -0,0 +1,518 @@
+#include "config.h"
+
+#include "scancodes/scancodes.h"
+
+#include <limits.h>
+#include <string.h>
+
+// all tables are sorted by name, for binary search
+typedef struct
+{
+  const char *str;
+  uint8_t val;
+} conversion_t;
+
+// generated from kb_scancodes.h at build time
+const static conversion_t kb_conversion[] = {
+#include "kb_conversion.h"
+};
+
+// value is modifier bit number
+const static conversion_t kb_mod_conversion[] = {
+    {"KB_LEFT_ALT", KB_MOD_LEFT_ALT},   {"KB_LEFT_CTRL", KB_MOD_LEFT_CTRL},
+    {"KB_LEFT_GUI", KB_MOD_LEFT_GUI},   {"KB_LEFT_SHIFT", KB_MOD_LEFT_SHIFT},
+    {"KB_RIGHT_ALT", KB_MOD_RIGHT_ALT}, {"KB_RIGHT_CTRL", KB_MOD_RIGHT_CTRL},
+    {"KB_RIGHT_GUI", KB_MOD_RIGHT_GUI}, {"KB_RIGHT_SHIFT", KB_MOD_RIGHT_SHIFT},
+};
+
+const static conversion_t ms_conversion[] = {
+    {"MOUSE_1", MS_SCANCODE_1},     {"MOUSE_2", MS_SCANCODE_2},      {"MOUSE_3", MS_SCANCODE_3},
+    {"MOUSE_DOWN", MS_SCANCODE_YP}, {"MOUSE_LEFT", MS_SCANCODE_XM},  {"MOUSE_RIGHT", MS_SCANCODE_XP},
+    {"MOUSE_UP", MS_SCANCODE_YM},
+};
+
+const static conversion_t vita_conversion[] = {
+    {"CIRCLE", V_SCANCODE_CIRCLE},
+    {"CROSS", V_SCANCODE_CROSS},
+    {"DPAD_DOWN", V_SCANCODE_DDOWN},
+    {"DPAD_LEFT", V_SCANCODE_DLEFT},
+    {"DPAD_RIGHT", V_SCANCODE_DRIGHT},
+    {"DPAD_UP", V_SCANCODE_DUP},
+    {"L1", V_SCANCODE_L1},
+    {"L2", V_SCANCODE_L2},
+    {"L3", V_SCANCODE_L3},
+    {"LEFT_ANALOG_DOWN", V_SCANCODE_LYP},
+    {"LEFT_ANALOG_LEFT", V_SCANCODE_LXM},
+    {"LEFT_ANALOG_RIGHT", V_SCANCODE_LXP},
+    {"LEFT_ANALOG_UP", V_SCANCODE_LYM},
+    {"PS", V_SCANCODE_PS},
+    {"R1", V_SCANCODE_R1},
+    {"R2", V_SCANCODE_R2},
+    {"R3", V_SCANCODE_R3},
+    {"RIGHT_ANALOG_DOWN", V_SCANCODE_RYP},
+    {"RIGHT_ANALOG_LEFT", V_SCANCODE_RXM},
+    {"RIGHT_ANALOG_RIGHT", V_SCANCODE_RXP},
+    {"RIGHT_ANALOG_UP", V_SCANCODE_RYM},
+    {"SELECT", V_SCANCODE_SELECT},
+    {"SQUARE", V_SCANCODE_SQUARE},
+    {"START", V_SCANCODE_START},
+    {"TRIANGLE", V_SCANCODE_TRIANGLE},
+};
+
+#define LOOKUP(table, str) lookup((table), sizeof(table) / sizeof((table)[0]), (str))
+
+// returns value for str, or -1 if it's not in table
+static int lookup(const conversion_t *table, int count, const char *str)
+{
+  int lo = 0;
+  int hi = count - 1;
+
+  while (lo <= hi)
+  {
+    int mid = (lo + hi) / 2;
+    int cmp = strcmp(str, table[mid].str);
+    if (cmp == 0)
+      return table[mid].val;
+    if (cmp < 0)
+      hi = mid - 1;
+    else
+      lo = mid + 1;
+  }
+
+  return -1;
+}
+
+VitaScancode str2enum(const char *str)
+{
+  int val = LOOKUP(vita_conversion, str);
+  return val < 0 ? V_SCANCODE_UNKNOWN : val;
+}
+
+static int str2int(const char *str)
+{
+  int sign = 1, base = 0, i = 0;
+
+  while (str[i] == ' ')
+  {
+    i++;
+  }
+
+  if (str[i] == '-' || str[i] == '+')
+  {
+    sign = 1 - 2 * (str[i++] == '-');
+  }
+
+  while (str[i] >= '0' && str[i] <= '9')
+  {
+    if (base > INT_MAX / 10 || (base == INT_MAX / 10 && str[i] - '0' > 7))
+    {
+      if (sign == 1)
+        return INT_MAX;
+      else
+        return INT_MIN;
+    }
+    base = 10 * base + (str[i++] - '0');
+  }
+  return base * sign;
+}
+
+// decimal like "-1.25" into Q8.8, clamped to -0xFFFF..0xFFFF
+static int str2q8(const char *str)
+{
+  int i = 0, sign = 1, whole = 0, frac = 0, scale = 1;
+
+  while (str[i] == ' ')
+    i++;
+
+  if (str[i] == '-' || str[i] == '+')
+    sign = 1 - 2 * (str[i++] == '-');
+
+  while (str[i] >= '0' && str[i] <= '9')
+  {
+    if (whole < 256)
+      whole = whole * 10 + (str[i] - '0');
+    i++;
+  }
+
+  if (str[i] == '.')
+  {
+    i++;
+    // 4 digits are finer than 1/256
+    while (str[i] >= '0' && str[i] <= '9' && scale < 10000)
+    {
+      frac = frac * 10 + (str[i++] - '0');
+      scale *= 10;
+    }
+  }
+
+  // fraction rounds up too, 255.9999 would be 0x10000
+  int q = whole * 256 + (frac * 256 + scale / 2) / scale;
+  return sign * (q > 0xFFFF ? 0xFFFF : q);
+}
+
+static int16_t str2sensitivity(const char *str)
+{
+  int q = str2q8(str);
+  return q < INT16_MIN ? INT16_MIN : (q > INT16_MAX ? INT16_MAX : q);
+}
+
+void bindings_clear(bindings_t *b)
+{
+  memset(b, 0, sizeof(bindings_t));
+  b->size = sizeof(bindings_t);
+}
+
+// "L2 + R1" into targets, returns their count or 0 if something is unknown
+static int parse_targets(const char *value, uint8_t *targets)
+{
+  int count = 0;
+
+  while (*value)
+  {
+    char name[24];
+    int len = 0;
+
+    while (*value == ' ')
+      value++;
+    while (*value && *value != '+' && *value != ' ')
+    {
+      if (len == sizeof(name) - 1)
+        return 0;
+      name[len++] = *value++;
+    }
+    if (!len)
+      return 0;
+    name[len] = '\0';
+    while (*value == ' ')
+      value++;
+
+    VitaScancode s = str2enum(name);
+    if (s == V_SCANCODE_UNKNOWN || count == TVIKEY_LIST_MAX)
+      return 0;
+    targets[count++] = s;
+
+    if (*value == '+')
+    {
+      if (!*++value)
+        return 0;
+    }
+    else if (*value)
+      return 0;
+  }
+
+  return count;
+}
+
+// value to store for targets, list is added to b->lists unless identical one is there.
+// 0 if lists are full
+static uint8_t bind_targets(bindings_t *b, const uint8_t *targets, int count)
+{
+  if (count == 1)
+    return targets[0];
+
+  int end = sizeof(b->lists);
+  while (end > 0 && !b->lists[end - 1])
+    end--;
+
+  // every list is stored with its terminator
+  uint8_t list[TVIKEY_LIST_MAX + 1];
+  memcpy(list, targets, count);
+  list[count] = 0;
+
+  // candidate too close to the end can't hold whole list, comparing it would read past lists
+  for (int off = 0; off < end && count + 1 <= (int)sizeof(b->lists) - off; off++)
+  {
+    if ((off == 0 || !b->lists[off - 1]) && memcmp(&b->lists[off], list, count + 1) == 0)
+      return TVIKEY_LIST | off;
+  }
+
+  int off = end ? end + 1 : 0;
+  if (off + count + 1 > (int)sizeof(b->lists))
+    return 0;
+
+  memcpy(&b->lists[off], list, count + 1);
+  return TVIKEY_LIST | off;
+}
+
+static int bind_input(bindings_t *b, uint8_t *input, const char *value)
+{
+  uint8_t targets[TVIKEY_LIST_MAX];
+  int count = parse_targets(value, targets);
+  if (!count)
+    return 0;
+
+  uint8_t v = bind_targets(b, targets, count);
+  if (!v)
+    return 0;
+
+  *input = v;
+  return 1;
+}
+
+// usb hid scancode of keyboard key or modifier, -1 if unknown
+static int str2key(const char *str)
+{
+  int key = LOOKUP(kb_conversion, str);
+  if (key >= 0)
+    return key;
+
+  int bit = LOOKUP(kb_mod_conversion, str);
+  return bit < 0 ? -1 : SC_LEFT_CONTROL + bit;
+}
+
+// "LAYER_<n>" and "LAYER_<n>_TOGGLE"
+static int apply_layer_key(bindings_t *b, const char *name, const char *value)
+{
+  if (strncmp(name, "LAYER_", 6) != 0 || name[6] < '1' || name[6] >= '0' + TVIKEY_LAYERS)
+    return 0;
+
+  int layer = name[6] - '1';
+  int key   = str2key(value);
+  if (key < 0)
+    return 0;
+
+  if (!name[7])
+    b->layer_hold[layer] = key;
+  else if (!strcmp(&name[7], "_TOGGLE"))
+    b->layer_toggle[layer] = key;
+  else
+    return 0;
+  return 1;
+}
+
+// "KB_<key>@<n>", layers have keyboard keys only
+static int apply_layer_binding(bindings_t *b, const char *name, const char *value)
+{
+  char key[32];
+  const char *at = strchr(name, '@');
+  if (at - name >= (int)sizeof(key) || at[1] < '1' || at[1] >= '0' + TVIKEY_LAYERS || at[2])
+    return 0;
+
+  memcpy(key, name, at - name);
+  key[at - name] = '\0';
+
+  int input = LOOKUP(kb_conversion, key);
+  if (input < 0)
+    return 0;
+  return bind_input(b, &b->layers[at[1] - '1'][input], value);
+}
+
+// "KB_LEFT_CTRL + KB_E" chord or "KB_DOWN > KB_RIGHT > KB_J" sequence
+static int apply_combo(bindings_t *b, const char *name, const char *value)
+{
+  tvikey_combo_t combo;
+  memset(&combo, 0, sizeof(combo));
+  combo.sequence = strchr(name, '>') != NULL;
+
+  char sep  = combo.sequence ? '>' : '+';
+  int count = 0;
+  int max   = combo.sequence ? TVIKEY_COMBO_KEYS : 3;
+  while (*name)
+  {
+    char key[32];
+    int len = 0;
+
+    while (*name == ' ')
+      name++;
+    while (*name && *name != sep && *name != ' ')
+    {
+      if (len == sizeof(key) - 1)
+        return 0;
+      key[len++] = *name++;
+    }
+    key[len] = '\0';
+    while (*name == ' ')
+      name++;
+
+    int k = str2key(key);
+    if (k <= 0 || count == max)
+      return 0;
+    combo.keys[count++] = k;
+
+    if (*name == sep)
+    {
+      if (!*++name)
+        return 0;
+    }
+    else if (*name)
+      return 0;
+  }
+  if (count < 2)
+    return 0;
+
+  // chord keys are held together, order doesn't matter
+  for (int i = 1; !combo.sequence && i < count; i++)
+  {
+    for (int j = i; j > 0 && combo.keys[j - 1] > combo.keys[j]; j--)
+    {
+      uint8_t t         = combo.keys[j];
+      combo.keys[j]     = combo.keys[j - 1];
+      combo.keys[j - 1] = t;
+    }
+  }
+
+  // same combo again replaces its binding
+  tvikey_combo_t *slot = NULL;
+  for (int i = 0; i < TVIKEY_COMBOS; i++)
+  {
+    tvikey_combo_t *c = &b->combos[i];
+    if (c->value && c->sequence == combo.sequence && memcmp(c->keys, combo.keys, sizeof(combo.keys)) == 0)
+    {
+      slot = c;
+      break;
+    }
+    if (!c->value && !slot)
+      slot = c;
+  }
+  if (!slot)
+    return 0;
+
+  uint8_t v;
+  if (!bind_input(b, &v, value))
+    return 0;
+
+  memcpy(slot, &combo, sizeof(combo));
+  slot->value = v;
+  return 1;
+}
+
+int bindings_apply(bindings_t *b, const char *name, const char *value)
+{
+  int found = 0;
+  int input;
+
+  if (strpbrk(name, "+>"))
+    found = apply_combo(b, name, value);
+  else if (strchr(name, '@'))
+    found = apply_layer_binding(b, name, value);
+  else if (!strncmp(name, "LAYER_", 6))
+    found = apply_layer_key(b, name, value);
+  else if ((input = LOOKUP(kb_conversion, name)) >= 0)
+    found = bind_input(b, &b->kb[input], value);
+  else if ((input = LOOKUP(kb_mod_conversion, name)) >= 0)
+    found = bind_input(b, &b->kb_mod[input], value);
+  else if ((input = LOOKUP(ms_conversion, name)) >= 0)
+    found = bind_input(b, &b->mouse[input], value);
+
+  if (!strcmp(name, "MS_SENSITIVITY_X"))
+  {
+    b->mouse_sensitivity_x = str2sensitivity(value);
+    found                  = 1;
+  }
+
+  if (!strcmp(name, "MS_SENSITIVITY_Y"))
+  {
+    b->mouse_sensitivity_y = str2sensitivity(value);
+    found                  = 1;
+  }
+
+  if (!strcmp(name, "MS_CURVE_EXPONENT"))
+  {
+    int q             = str2q8(value);
+    b->curve_exponent = q < 0 ? 0 : q;
+    found             = 1;
+  }
+
+  if (!strcmp(name, "MS_ANTI_DEADZONE"))
+  {
+    int percent            = str2int(value);
+    b->curve_anti_deadzone = percent < 0 ? 0 : (percent > 100 ? 100 : percent);
+    found                  = 1;
+  }
+
+  if (!strcmp(name, "MS_MAX_SPEED"))
+  {
+    int speed          = str2int(value);
+    b->curve_max_speed = speed < 1 ? 1 : (speed > UINT8_MAX ? UINT8_MAX : speed);
+    found              = 1;
+  }
+
+  if (!strcmp(name, "MS_ACCELERATION"))
+  {
+    int percent           = str2int(value);
+    b->curve_acceleration = percent < 0 ? 0 : (percent > UINT8_MAX ? UINT8_MAX : percent);
+    found                 = 1;
+  }
+
+  if (!strcmp(name, "MS_SMOOTHING"))
+  {
+    int ms             = str2int(value);
+    b->mouse_smoothing = ms < 0 ? 0 : (ms > TVIKEY_MOUSE_FILTER_MAX ? TVIKEY_MOUSE_FILTER_MAX : ms);
+    found              = 1;
+  }
+
+  if (!strcmp(name, "MS_DECAY"))
+  {
+    int ms         = str2int(value);
+    b->mouse_decay = ms < 0 ? 0 : (ms > TVIKEY_MOUSE_FILTER_MAX ? TVIKEY_MOUSE_FILTER_MAX : ms);
+    found          = 1;
+  }
+
+  if (!strcmp(name, "COMBO_WINDOW"))
+  {
+    int ms          = str2int(value);
+    b->combo_window = ms < 1 ? 1 : (ms > UINT16_MAX ? UINT16_MAX : ms);
+    found           = 1;
+  }
+
+  return found;
+}
+
+static int valid_target(uint8_t v)
+{
+  return v >= V_SCANCODE_DUP && v <= V_SCANCODE_PS;
+}
+
+// input callbacks walk lists up to terminator, so it must be there
+static int valid_list(const bindings_t *b, int off)
+{
+  for (int i = 0; i <= TVIKEY_LIST_MAX && off + i < (int)sizeof(b->lists); i++)
+  {
+    uint8_t v = b->lists[off + i];
+    if (!v)
+      return i > 0;
+    if (!valid_target(v))
+      return 0;
+  }
+  return 0;
+}
+
+static int valid_inputs(const bindings_t *b, const uint8_t *inputs, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    if (inputs[i] & TVIKEY_LIST)
+    {
+      if (!valid_list(b, inputs[i] & ~TVIKEY_LIST))
+        return 0;
+    }
+    else if (inputs[i] != 0 && !valid_target(inputs[i]))
+      return 0;
+  }
+  return 1;
+}
+
+int bindings_validate(const bindings_t *b)
+{
+  for (int i = 0; i < TVIKEY_COMBOS; i++)
+  {
+    if (!valid_inputs(b, &b->combos[i].value, 1))
+      return 0;
+  }
+
+  return valid_inputs(b, b->kb, sizeof(b->kb)) && valid_inputs(b, b->kb_mod, sizeof(b->kb_mod))
+         && valid_inputs(b, b->mouse, sizeof(b->mouse)) && valid_inputs(b, &b->layers[0][0], sizeof(b->layers));
+}
+
+int config_handler(void *user, const char *section, const char *name, const char *value)
+{
+  configuration *pconfig = (configuration *)user;
+
+  if (strcmp(section, pconfig->titleid) == 0)
+  {
+    pconfig->loaded = 1;
+    bindings_apply(&pconfig->b, name, value);
+  }
+
+  return 1;
+}
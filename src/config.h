@@ -2,14 +2,33 @@
 #define __CONFIG_H__
 
 #include <stdint.h>
+#include <tvikey.h>
+
+#define CONFIG_DIR "ux0:/data"
+#define CONFIG_INI_PATH "ux0:/data/tvikey.ini"
+#define CONFIG_BIN_PATH "ux0:/data/tvikey.bin"
+
+// same layout is exported to user space
+typedef tvikey_bindings_t bindings_t;
 
 typedef struct
 {
-  uint8_t kb[256];
-  uint8_t kb_mod[8];
-  uint8_t mouse[8];
-  uint8_t mouse_sensitivity_x;
-  uint8_t mouse_sensitivity_y;
-} bindings_t;
-
-#endif
\ No newline at end of file
+  int loaded;
+  char titleid[16];
+  bindings_t b;
+} configuration;
+
+// clear bindings, so that every input is unbound
+void bindings_clear(bindings_t *b);
+
+// apply single "name = value" pair to bindings
+// returns 1 if both name and value were recognized, 0 otherwise
+int bindings_apply(bindings_t *b, const char *name, const char *value);
+
+// returns 1 if every bound value is a known vita input or well formed list of them
+int bindings_validate(const bindings_t *b);
+
+// ini_handler, fills configuration for section equal to its titleid
+int config_handler(void *user, const char *section, const char *name, const char *value);
+
+#endif
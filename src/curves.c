@@ -0,0 +1,99 @@
+#include "curves.h"
+
+// everything is integer, tables are built in kernel without touching vfp
+#define Q16 65536
+
+// 2^(2^-(k+1)) in Q30
+static const uint32_t roots[16] = {
+    0x5A82799A, 0x4C1BF829, 0x45CAE0F2, 0x42D561B4, 0x4166C34C, 0x40B268FA, 0x4058F6A8, 0x402C6BE9,
+    0x4016321B, 0x400B1818, 0x40058BCE, 0x4002C5D8, 0x400162E8, 0x4000B173, 0x400058B9, 0x40002C5D,
+};
+
+// log2(x) for 0 < x < 1.0, both Q16
+static int32_t log2_q16(uint32_t x)
+{
+  int32_t result = 0;
+
+  while (x < Q16)
+  {
+    x <<= 1;
+    result -= Q16;
+  }
+
+  // x is in [1, 2) now, every squaring gives next fraction bit
+  for (int32_t bit = Q16 >> 1; bit; bit >>= 1)
+  {
+    x = (uint32_t)(((uint64_t)x * x) >> 16);
+    if (x >= 2 * Q16)
+    {
+      x >>= 1;
+      result += bit;
+    }
+  }
+  return result;
+}
+
+// 2^t for t <= 0, both Q16
+static uint32_t exp2_q16(int32_t t)
+{
+  int32_t n  = t >> 16; // floor
+  uint32_t f = t & 0xFFFF;
+
+  uint64_t r = 1u << 30;
+  for (int k = 0; k < 16; k++)
+  {
+    if (f & (0x8000 >> k))
+      r = (r * roots[k]) >> 30;
+  }
+
+  int shift = 14 - n;
+  return shift >= 32 ? 0 : (uint32_t)(r >> shift);
+}
+
+// x^e for x in [0, 1] Q16, e in Q8.8
+static uint32_t pow_q16(uint32_t x, uint32_t e)
+{
+  if (x == 0 || x >= Q16 || e == 0x100)
+    return x;
+
+  int64_t t = ((int64_t)log2_q16(x) * e) >> 8;
+  return t < -31 * Q16 ? 0 : exp2_q16((int32_t)t);
+}
+
+static int has_curve(const bindings_t *b)
+{
+  return b->curve_exponent || b->curve_anti_deadzone || b->curve_max_speed || b->curve_acceleration;
+}
+
+uint8_t mouse_curve_value(const bindings_t *b, int8_t movement)
+{
+  int m = movement < 0 ? -movement : movement;
+
+  if (!has_curve(b))
+    return movement + 128;
+
+  if (m == 0)
+    return 128;
+
+  // stick goes further to negative side
+  int full      = movement < 0 ? 128 : 127;
+  int max_speed = b->curve_max_speed ? b->curve_max_speed : full;
+  uint32_t x    = m >= max_speed ? Q16 : (uint32_t)(m * Q16 / max_speed);
+
+  uint32_t y = pow_q16(x, b->curve_exponent ? b->curve_exponent : 0x100);
+  if (b->curve_acceleration)
+  {
+    uint64_t boosted = (uint64_t)y * (Q16 + (uint64_t)x * b->curve_acceleration / 100) >> 16;
+    y                = boosted > Q16 ? Q16 : (uint32_t)boosted;
+  }
+
+  int dz  = (b->curve_anti_deadzone > 100 ? 100 : b->curve_anti_deadzone) * full / 100;
+  int mag = dz + (int)(((uint64_t)(full - dz) * y + Q16 / 2) >> 16);
+  return movement < 0 ? 128 - mag : 128 + mag;
+}
+
+void mouse_curve_compile(const bindings_t *b, uint8_t lut[256])
+{
+  for (int i = 0; i < 256; i++)
+    lut[i] = mouse_curve_value(b, (int8_t)i);
+}
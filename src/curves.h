@@ -0,0 +1,18 @@
+#ifndef __CURVES_H__
+#define __CURVES_H__
+
+#include "config.h"
+
+#include <stdint.h>
+
+// Mouse movement to stick position, table is indexed by movement after sensitivity as uint8_t.
+// Without curve settings it's movement + 128, same as always.
+// With them, speed = |movement| / max_speed clamped to 1, shaped by
+// speed^exponent, boosted by acceleration * speed and moved past anti-deadzone.
+
+void mouse_curve_compile(const bindings_t *b, uint8_t lut[256]);
+
+// single entry, exposed for host checks against floating point math
+uint8_t mouse_curve_value(const bindings_t *b, int8_t movement);
+
+#endif // __CURVES_H__
@@ -1,9 +1,11 @@
 #include "keyboard.h"
 
 #include "../config.h"
+#include "../profile.h"
 
 #include <psp2kern/ctrl.h>
 #include <psp2kern/kernel/debug.h>
+#include <psp2kern/kernel/threadmgr.h>
 
 #define ksceUsbdSetBootProto(pid, iface)                                                                               \
   ({                                                                                                                   \
@@ -48,6 +50,9 @@ uint8_t Keyboard_attach(InputDevice *c, int device_id, int port)
   c->buffer_size = 8;
   c->device_id   = device_id;
   c->port        = port;
+  keystate_clear(&c->keys);
+  combo_reset(&c->combo);
+  c->layer_toggled = 0;
 
   // check device hid type
 
@@ -137,11 +142,6 @@ uint8_t Keyboard_attach(InputDevice *c, int device_id, int port)
   return 1;
 }
 
-static inline uint8_t bit(uint8_t data, int bit)
-{
-  return (data >> bit) & 1;
-}
-
 static inline int clamp(int value, int min, int max)
 {
   if (value <= min)
@@ -151,12 +151,56 @@ static inline int clamp(int value, int min, int max)
   return value;
 }
 
-extern bindings_t bind_config;
-
 #include "process_bind.h"
 
+// presses flip toggled layers and may complete combos, held layer keys win over toggled layer.
+// returns layer in effect for current report
+static int process_events(InputDevice *c, const profile_t *p)
+{
+  const bindings_t *b = &p->b;
+  SceUInt64 now       = 0;
+
+  key_event_t e;
+  while (keystate_pop(&c->keys, &e))
+  {
+#if defined(DEBUG)
+    ksceDebugPrintf("key %02x %s\n", e.key, e.pressed ? "down" : "up");
+#endif
+    if (!e.pressed)
+      continue;
+    for (int l = 0; l < TVIKEY_LAYERS - 1; l++)
+    {
+      if (b->layer_toggle[l] && b->layer_toggle[l] == e.key)
+        c->layer_toggled = (c->layer_toggled == l + 1) ? 0 : l + 1;
+    }
+
+    // all events of report happened at once
+    if (!now)
+      now = ksceKernelGetSystemTimeWide();
+    combo_press(&c->combo, b, &p->c.combos, &c->keys, e.key, now);
+  }
+
+  int layer = c->layer_toggled;
+  for (int l = 0; l < TVIKEY_LAYERS - 1; l++)
+  {
+    if (b->layer_hold[l] && keystate_pressed(&c->keys, b->layer_hold[l]))
+      layer = l + 1;
+  }
+  return layer;
+}
+
 uint8_t Keyboard_processReport(InputDevice *c, size_t length)
 {
+  const profile_t *p  = profile_enter();
+  const bindings_t *b = &p->b;
+
+  keystate_update(&c->keys, c->buffer, length);
+  int layer                   = process_events(c, p);
+  const tvikey_combo_t *combo = combo_active(&c->combo, b, &c->keys);
+
+  // switching layer is just switching table, keys unbound in layer fall through to base one
+  const uint8_t *kb = layer ? b->layers[layer - 1] : b->kb;
+
   // reset everything
   c->controlData.buttons = 0;
   c->controlData.leftX   = 128;
@@ -166,30 +210,28 @@ uint8_t Keyboard_processReport(InputDevice *c, size_t length)
   c->controlData.lt      = 0;
   c->controlData.rt      = 0;
 
-  for (int i = 1; i < 8; i++)
+  // modifiers of active combo only send combo's binding, same as its keys below
+  uint8_t mods = c->buffer[0] & ~(combo ? combo_mods(combo) : 0);
+  c->controlData.buttons |= p->c.mod_buttons[0][mods & 0xF] | p->c.mod_buttons[1][mods >> 4];
+  // only modifiers that move axes need to be applied one by one
+  for (uint8_t m = mods & p->c.mod_axes; m; m &= m - 1)
   {
-    if (bind_config.kb_mod[i] != 0xFF && bind_config.kb_mod[i] != 0)
-    {
-      if (bit(c->buffer[0], i))
-      {
-        processBind(c, bind_config.kb_mod[i]);
-      }
-    }
+    processBind(&c->controlData, b, b->kb_mod[__builtin_ctz(m)]);
   }
 
-  for (int i = 0; i < 256; i++)
+  // kb is indexed by scancode, so only keys present in report are looked at.
+  // same bytes keystate saw, rest of buffer is left from longer report
+  for (size_t j = 2; j < length; j++)
   {
-    if (bind_config.kb[i] != 0xFF && bind_config.kb[i] != 0)
-    {
-      for (int j = 2; j < c->buffer_size; j++)
-      {
-        if (c->buffer[j] > 0 && c->buffer[j] == i)
-        {
-          processBind(c, bind_config.kb[i]);
-        }
-      }
-    }
+    uint8_t key = c->buffer[j];
+    // keys of active combo only send combo's binding
+    if (key > 0 && !(combo && combo_uses(combo, key)))
+      processBind(&c->controlData, b, kb[key] ? kb[key] : b->kb[key]);
   }
 
+  if (combo)
+    processBind(&c->controlData, b, combo->value);
+
+  profile_leave(p);
   return 1;
 }
@@ -1,10 +1,12 @@
 #include "mouse.h"
 
 #include "../config.h"
+#include "../profile.h"
 #include "../scancodes/scancodes.h"
 
 #include <psp2kern/ctrl.h>
 #include <psp2kern/kernel/debug.h>
+#include <psp2kern/kernel/threadmgr.h>
 
 #define ksceUsbdSetBootProto(pid, iface)                                                                               \
   ({                                                                                                                   \
@@ -45,10 +47,19 @@ uint8_t Mouse_probe(int device_id)
 
 uint8_t Mouse_attach(InputDevice *c, int device_id, int port)
 {
-  c->type        = MOUSE;
-  c->buffer_size = 8;
-  c->device_id   = device_id;
-  c->port        = port;
+  c->type            = MOUSE;
+  c->buffer_size     = 8;
+  c->device_id       = device_id;
+  c->port            = port;
+  c->mouse_carry[0]  = 0;
+  c->mouse_carry[1]  = 0;
+  c->mouse_delta     = 0;
+  c->motion          = 0;
+  c->motion_time     = ksceKernelGetSystemTimeWide();
+  c->report_time     = c->motion_time;
+  c->delta_time      = c->motion_time;
+  c->mouse_smooth[0] = 0;
+  c->mouse_smooth[1] = 0;
 
   // check device hid type
 
@@ -143,21 +154,70 @@ static inline uint8_t bit(uint8_t data, int bit)
   return (data >> bit) & 1;
 }
 
-static inline int clamp(int value, int min, int max)
+#include "process_bind.h"
+
+#define MOTION_XM (1 << 16)
+#define MOTION_XP (1 << 17)
+#define MOTION_YM (1 << 18)
+#define MOTION_YP (1 << 19)
+
+// whole counts of delta * sensitivity go out now, fraction is kept for next read,
+// so slow movement adds up instead of being rounded away. ratio is Q8 share of MOTION_REFERENCE.
+static inline int8_t scale(int16_t *carry, int32_t delta, int16_t sensitivity, uint32_t ratio)
 {
-  if (value <= min)
-    return min;
-  if (value >= max)
-    return max;
-  return value;
+  if (delta < INT16_MIN)
+    delta = INT16_MIN;
+  else if (delta > INT16_MAX)
+    delta = INT16_MAX;
+
+  int64_t move = (int64_t)delta * sensitivity;
+  move         = move < 0 ? -((-move * ratio) >> 8) : (move * ratio) >> 8;
+
+  // past full deflection the fraction doesn't matter, keeps division 32 bit
+  int64_t sum = *carry + move;
+  int acc     = sum < INT8_MIN * 256 ? INT8_MIN * 256 : (sum > INT8_MAX * 256 ? INT8_MAX * 256 : sum);
+  int whole   = acc / 256; // towards zero, same for both directions
+  *carry      = acc - whole * 256;
+  return whole;
 }
 
-extern bindings_t bind_config;
+static inline uint32_t ms_to_us(uint16_t ms)
+{
+  return (ms > TVIKEY_MOUSE_FILTER_MAX ? TVIKEY_MOUSE_FILTER_MAX : ms) * 1000;
+}
 
-#include "process_bind.h"
+// Q8 stick movement after read that took v. Without new movement stick goes down in straight line
+// to reach 0 mouse_decay after last report, otherwise it moves towards v with time constant mouse_smoothing.
+static int32_t filter(const bindings_t *b, int32_t s, int8_t v, int moving, uint32_t elapsed, uint32_t stale)
+{
+  uint32_t decay = ms_to_us(b->mouse_decay);
+  if (!moving && decay)
+  {
+    if (stale >= decay)
+      return 0;
+    uint32_t left = decay - stale;
+    return s * (int32_t)((left << 8) / (left + elapsed)) / 256;
+  }
+
+  uint32_t smoothing = ms_to_us(b->mouse_smoothing);
+  if (!smoothing)
+    return v * 256;
+
+  // share of new value depends on time since last read, not on how often game reads
+  int32_t alpha = (elapsed << 8) / (elapsed + smoothing);
+  return s + (v * 256 - s) * alpha / 256;
+}
+
+static inline uint32_t direction(int32_t delta, uint32_t minus, uint32_t plus)
+{
+  return delta < 0 ? minus : (delta > 0 ? plus : 0);
+}
 
 uint8_t Mouse_processReport(InputDevice *c, size_t length)
 {
+  const profile_t *p  = profile_enter();
+  const bindings_t *b = &p->b;
+
   // reset everything
   c->controlData.buttons = 0;
   c->controlData.leftX   = 128;
@@ -167,63 +227,90 @@ uint8_t Mouse_processReport(InputDevice *c, size_t length)
   c->controlData.lt      = 0;
   c->controlData.rt      = 0;
 
-  int16_t x = (int8_t)c->buffer[1];
-  int16_t y = (int8_t)c->buffer[2];
-  x         = clamp(x * bind_config.mouse_sensitivity_x, INT8_MIN, INT8_MAX);
-  y         = clamp(y * bind_config.mouse_sensitivity_y, INT8_MIN, INT8_MAX);
-
-  x = x + 128;
-  y = y + 128;
-
   for (int i = 0; i < 3; i++) // buttons
   {
-    if (bind_config.mouse[i] != 0xFF && bind_config.mouse[i] != 0)
+    if (bit(c->buffer[0], i))
     {
-      if (bit(c->buffer[0], i))
-      {
-        processBind(c, bind_config.mouse[i]);
-      }
+      processBind(&c->controlData, b, b->mouse[i]);
     }
   }
 
-  int8_t raw_x = (int8_t)c->buffer[1];
-  int8_t raw_y = (int8_t)c->buffer[2];
-
-  if (bind_config.mouse[MS_SCANCODE_XM] != 0xFF && bind_config.mouse[MS_SCANCODE_XM] != 0)
+  // both axes in one atomic add, borrow of negative x from y is undone in Mouse_applyMotion
+  int8_t dx = (int8_t)c->buffer[1];
+  int8_t dy = (int8_t)c->buffer[2];
+  if (dx || dy)
   {
-    if (raw_x < 0)
-    {
-      processAnalogBind(c, bind_config.mouse[MS_SCANCODE_XM], x);
-      processButtonBind(c, bind_config.mouse[MS_SCANCODE_XM]);
-    }
+    SceUInt64 now = ksceKernelGetSystemTimeWide();
+    uint64_t add  = ((uint64_t)(int64_t)dy << 32) + (uint64_t)(int64_t)dx;
+    if (__atomic_add_fetch(&c->mouse_delta, add, __ATOMIC_RELAXED) == add)
+      __atomic_store_n(&c->delta_time, now, __ATOMIC_RELAXED);
+    __atomic_store_n(&c->report_time, now, __ATOMIC_RELAXED);
   }
 
-  if (bind_config.mouse[MS_SCANCODE_XP] != 0xFF && bind_config.mouse[MS_SCANCODE_XP] != 0)
-  {
-    if (raw_x > 0)
-    {
-      processAnalogBind(c, bind_config.mouse[MS_SCANCODE_XP], x);
-      processButtonBind(c, bind_config.mouse[MS_SCANCODE_XP]);
-    }
-  }
+  profile_leave(p);
+  return 1;
+}
 
-  if (bind_config.mouse[MS_SCANCODE_YM] != 0xFF && bind_config.mouse[MS_SCANCODE_YM] != 0)
-  {
-    if (raw_y < 0)
-    {
-      processAnalogBind(c, bind_config.mouse[MS_SCANCODE_YM], y);
-      processButtonBind(c, bind_config.mouse[MS_SCANCODE_YM]);
-    }
-  }
+void Mouse_applyMotion(InputDevice *c, ControlData *data)
+{
+  const profile_t *p  = profile_enter();
+  const bindings_t *b = &p->b;
+
+  SceUInt64 now  = ksceKernelGetSystemTimeWide();
+  SceUInt64 last = c->motion_time;
 
-  if (bind_config.mouse[MS_SCANCODE_YP] != 0xFF && bind_config.mouse[MS_SCANCODE_YP] != 0)
+  // every process reading controller ends up here, only one read per interval takes deltas
+  if (now - last >= MOTION_MIN_INTERVAL && __sync_bool_compare_and_swap(&c->motion_time, last, now))
   {
-    if (raw_y > 0)
-    {
-      processAnalogBind(c, bind_config.mouse[MS_SCANCODE_YP], y);
-      processButtonBind(c, bind_config.mouse[MS_SCANCODE_YP]);
-    }
+    uint64_t delta = __atomic_exchange_n(&c->mouse_delta, 0, __ATOMIC_ACQUIRE);
+    int32_t dx     = (int32_t)delta;
+    int32_t dy     = (int32_t)((delta - (uint64_t)(int64_t)dx) >> 32);
+
+    // Delta came in since its first report, which itself stands for one reference time.
+    // While mouse moves that's never shorter than time since previous read, after idle
+    // or on first read it keeps burst from being spread over whole gap.
+    SceUInt64 elapsed = now - last;
+    SceUInt64 first   = __atomic_load_n(&c->delta_time, __ATOMIC_RELAXED);
+    SceUInt64 span    = elapsed;
+    if (first > last && now - first + MOTION_REFERENCE < span)
+      span = now - first + MOTION_REFERENCE;
+    if (span > MOTION_REFERENCE << 8) // long gap without reports, keeps division 32 bit
+      span = MOTION_REFERENCE << 8;
+    uint32_t ratio = (MOTION_REFERENCE << 8) / (uint32_t)span;
+
+    int8_t x = scale(&c->mouse_carry[0], dx, b->mouse_sensitivity_x, ratio);
+    int8_t y = scale(&c->mouse_carry[1], dy, b->mouse_sensitivity_y, ratio);
+
+    // filter times are at most TVIKEY_MOUSE_FILTER_MAX, longer ones give same result
+    SceUInt64 stale    = now - __atomic_load_n(&c->report_time, __ATOMIC_RELAXED);
+    uint32_t e         = elapsed > TVIKEY_MOUSE_FILTER_MAX * 1000 ? TVIKEY_MOUSE_FILTER_MAX * 1000 : elapsed;
+    uint32_t s         = stale > TVIKEY_MOUSE_FILTER_MAX * 1000 ? TVIKEY_MOUSE_FILTER_MAX * 1000 : stale;
+    int moving         = dx || dy;
+    c->mouse_smooth[0] = filter(b, c->mouse_smooth[0], x, moving, e, s);
+    c->mouse_smooth[1] = filter(b, c->mouse_smooth[1], y, moving, e, s);
+    x                  = c->mouse_smooth[0] / 256;
+    y                  = c->mouse_smooth[1] / 256;
+
+    // direction binds follow raw delta while it's scaled away
+    c->motion = (uint8_t)x | (uint8_t)y << 8 | direction(x ? x : dx, MOTION_XM, MOTION_XP)
+              | direction(y ? y : dy, MOTION_YM, MOTION_YP);
   }
 
-  return 1;
+  uint32_t m = c->motion;
+
+  // response curve is baked into table
+  uint8_t x = p->c.mouse_lut[m & 0xFF];
+  uint8_t y = p->c.mouse_lut[(m >> 8) & 0xFF];
+
+  if (m & MOTION_XM)
+    processAnalogBind(data, b, b->mouse[MS_SCANCODE_XM], x);
+  else if (m & MOTION_XP)
+    processAnalogBind(data, b, b->mouse[MS_SCANCODE_XP], x);
+
+  if (m & MOTION_YM)
+    processAnalogBind(data, b, b->mouse[MS_SCANCODE_YM], y);
+  else if (m & MOTION_YP)
+    processAnalogBind(data, b, b->mouse[MS_SCANCODE_YP], y);
+
+  profile_leave(p);
 }
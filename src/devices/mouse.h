@@ -3,8 +3,15 @@
 
 #include "../inputdevice.h"
 
+// Movement isn't sent per usb report, deltas of all reports are summed until controller is read
+// and turned into speed over time since previous read, so polling rate of mouse doesn't matter.
+#define MOTION_REFERENCE 8000    // us, delta summed over this time gives same deflection as one report at 125 Hz
+#define MOTION_MIN_INTERVAL 4000 // us, reads closer than this repeat movement of previous one
+
 uint8_t Mouse_attach(InputDevice *c, int device_id, int port);
 uint8_t Mouse_probe(int device_id);
 uint8_t Mouse_processReport(InputDevice *c, size_t length);
+// add movement since last controller read to data, called from ctrl hooks
+void Mouse_applyMotion(InputDevice *c, ControlData *data);
 
 #endif // __MOUSE_H__
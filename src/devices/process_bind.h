@@ -1,8 +1,47 @@
 #ifndef __PROCESS_BIND_H__
 #define __PROCESS_BIND_H__
 
-void processBind(InputDevice *c, uint8_t bind);
-void processAnalogBind(InputDevice *c, uint8_t bind, uint8_t value);
-void processButtonBind(InputDevice *c, uint8_t bind);
+#include "../actions.h"
+#include "../inputdevice.h"
 
-#endif
\ No newline at end of file
+// Lists are checked to be terminated when bindings are loaded,
+// so walking them is bounded by TVIKEY_LIST_MAX.
+// For a list value actions[] is a no-op, single targets skip the loop.
+
+// digital input, e.g. key or mouse button
+static inline void processBind(ControlData *d, const bindings_t *b, uint8_t bind)
+{
+  const action_t *a = &actions[bind];
+  d->buttons |= a->buttons;
+  d->axes[a->axis] = a->value;
+
+  if (bind & TVIKEY_LIST)
+  {
+    for (const uint8_t *l = &b->lists[bind & ~TVIKEY_LIST]; *l; l++)
+    {
+      a = &actions[*l];
+      d->buttons |= a->buttons;
+      d->axes[a->axis] = a->value;
+    }
+  }
+}
+
+// analog input, e.g. mouse movement, sets axis to given value instead
+static inline void processAnalogBind(ControlData *d, const bindings_t *b, uint8_t bind, uint8_t value)
+{
+  const action_t *a = &actions[bind];
+  d->buttons |= a->buttons;
+  d->axes[a->axis] = value;
+
+  if (bind & TVIKEY_LIST)
+  {
+    for (const uint8_t *l = &b->lists[bind & ~TVIKEY_LIST]; *l; l++)
+    {
+      a = &actions[*l];
+      d->buttons |= a->buttons;
+      d->axes[a->axis] = value;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,256 @@
+#include "ini_index.h"
+
+#include "arena.h"
+#include "config.h"
+#include "util/ini.h"
+#include "util/iostat.h"
+#include "util/trie.h"
+
+#include <psp2kern/kernel/debug.h>
+#include <psp2kern/kernel/sysclib.h>
+
+#define INDEX_MAX_SECTIONS 4096
+
+typedef struct
+{
+  char name[16]; // empty for free slot
+  unsigned int offset;
+} index_entry_t;
+
+// open addressing table of plain sections, kept at most half full
+static index_entry_t *entries;
+static unsigned int mask;
+static int count;
+static SceIoStat entries_stat;
+static int too_big; // index for file with entries_stat doesn't fit into arena
+
+// wildcard sections in file order, trie values index them
+static index_entry_t *patterns;
+static int pattern_count;
+static trie_t trie;
+
+typedef struct
+{
+  int sections;
+  int patterns;
+  int nodes;
+} section_count_t;
+
+typedef struct
+{
+  const char *titleid;
+  int score;
+  char *section;
+  unsigned int *offset;
+} scan_t;
+
+static uint32_t hash(const char *s)
+{
+  uint32_t h = 2166136261u;
+  while (*s)
+  {
+    h ^= (uint8_t)*s++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static index_entry_t *probe(const char *name)
+{
+  for (uint32_t i = hash(name) & mask;; i = (i + 1) & mask)
+  {
+    if (!entries[i].name[0] || strncmp(entries[i].name, name, sizeof(entries[i].name)) == 0)
+      return &entries[i];
+  }
+}
+
+// section can be matched against titleid at all
+static int indexable(const char *name)
+{
+  size_t len = strnlen(name, sizeof(entries[0].name));
+  return len > 0 && len < sizeof(entries[0].name) && trie_is_pattern(name) >= 0;
+}
+
+static int count_section(void *user, const char *section, unsigned int offset)
+{
+  section_count_t *c = (section_count_t *)user;
+
+  if (!indexable(section))
+    return 1;
+
+  if (trie_is_pattern(section))
+  {
+    c->patterns++;
+    c->nodes += trie_nodes_needed(section);
+  }
+  else
+  {
+    c->sections++;
+  }
+  return 1;
+}
+
+static int insert_section(void *user, const char *section, unsigned int offset)
+{
+  int *inserted = (int *)user;
+
+  if (!indexable(section))
+    return 1;
+
+  if (trie_is_pattern(section))
+  {
+    // file may grow between passes
+    if (pattern_count == INDEX_MAX_SECTIONS || !patterns)
+      return 1;
+
+    // first section wins, same as in ini_parse
+    if (trie_insert(&trie, section, pattern_count) == 0)
+    {
+      index_entry_t *p = &patterns[pattern_count++];
+      strncpy(p->name, section, sizeof(p->name));
+      p->offset = offset;
+    }
+    return 1;
+  }
+
+  if (*inserted >= count)
+    return 1;
+
+  index_entry_t *e = probe(section);
+  if (!e->name[0])
+  {
+    strncpy(e->name, section, sizeof(e->name));
+    e->offset = offset;
+    (*inserted)++;
+  }
+  return 1;
+}
+
+// without index, pick best section in single pass over file
+static int scan_section(void *user, const char *section, unsigned int offset)
+{
+  scan_t *s = (scan_t *)user;
+
+  if (!indexable(section))
+    return 1;
+
+  int score = trie_match(section, s->titleid);
+  if (score > s->score)
+  {
+    s->score = score;
+    strncpy(s->section, section, 16);
+    *s->offset = offset;
+  }
+  return 1;
+}
+
+static void drop_index()
+{
+  arena_reset(ARENA_INI_INDEX);
+  entries       = NULL;
+  patterns      = NULL;
+  pattern_count = 0;
+  too_big       = 0;
+}
+
+static int build_index(const SceIoStat *st)
+{
+  drop_index();
+
+  section_count_t c;
+  memset(&c, 0, sizeof(c));
+  int ret = ini_parse_sections(CONFIG_INI_PATH, count_section, &c);
+  if (ret < 0)
+    return ret;
+
+  count = c.sections;
+  if (count > INDEX_MAX_SECTIONS || c.patterns > INDEX_MAX_SECTIONS)
+  {
+    ksceDebugPrintf("Too many sections in '" CONFIG_INI_PATH "': %d\n", count + c.patterns);
+    return -1;
+  }
+
+  unsigned int capacity = 16;
+  while (capacity < (unsigned int)count * 2)
+    capacity <<= 1;
+
+  entries = arena_alloc(ARENA_INI_INDEX, capacity * sizeof(index_entry_t));
+  if (entries && c.patterns)
+  {
+    patterns       = arena_alloc(ARENA_INI_INDEX, c.patterns * sizeof(index_entry_t));
+    trie_node_t *n = arena_alloc(ARENA_INI_INDEX, (c.nodes + 1) * sizeof(trie_node_t));
+    if (patterns && n)
+      trie_init(&trie, n, c.nodes + 1);
+    else
+      entries = NULL;
+  }
+
+  if (!entries)
+  {
+    // don't retry on every lookup, just scan sections until file changes
+    arena_reset(ARENA_INI_INDEX);
+    patterns = NULL;
+    memcpy(&entries_stat, st, sizeof(SceIoStat));
+    too_big = 1;
+    return -1;
+  }
+  mask = capacity - 1;
+
+  int inserted = 0;
+  ret          = ini_parse_sections(CONFIG_INI_PATH, insert_section, &inserted);
+  if (ret < 0)
+  {
+    drop_index();
+    return ret;
+  }
+
+  memcpy(&entries_stat, st, sizeof(SceIoStat));
+  ksceDebugPrintf("Indexed %d sections and %d patterns of '" CONFIG_INI_PATH "'\n", inserted, pattern_count);
+  return 0;
+}
+
+static int scan(const char *titleid, char *section, unsigned int *offset)
+{
+  scan_t s = {.titleid = titleid, .score = -1, .section = section, .offset = offset};
+
+  int ret = ini_parse_sections(CONFIG_INI_PATH, scan_section, &s);
+  if (ret < 0)
+    return ret;
+
+  return s.score >= 0;
+}
+
+int ini_index_find(const char *titleid, char *section, unsigned int *offset)
+{
+  SceIoStat st;
+
+  int ret = ksceIoGetstat(CONFIG_INI_PATH, &st);
+  if (ret < 0)
+  {
+    drop_index();
+    return ret;
+  }
+
+  if (!(too_big && iostat_same(&entries_stat, &st)) && (!entries || !iostat_same(&entries_stat, &st)))
+    build_index(&st);
+
+  if (!entries)
+    return scan(titleid, section, offset);
+
+  if (!indexable(titleid))
+    return 0;
+
+  // exact section beats any pattern
+  index_entry_t *e = probe(titleid);
+  if (!e->name[0])
+  {
+    int32_t i = patterns ? trie_find(&trie, titleid) : -1;
+    if (i < 0)
+      return 0;
+    e = &patterns[i];
+  }
+
+  memcpy(section, e->name, sizeof(e->name));
+  *offset = e->offset;
+  return 1;
+}
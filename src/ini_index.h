@@ -0,0 +1,11 @@
+#ifndef __INI_INDEX_H__
+#define __INI_INDEX_H__
+
+// Hash index of [section] offsets in tvikey.ini, plus trie of wildcard sections
+// rebuilt on lookup whenever file size or mtime changes
+
+// Returns 1 with name and offset of most specific section matching titleid,
+// 0 if there's none, < 0 on error. section must hold 16 chars.
+int ini_index_find(const char *titleid, char *section, unsigned int *offset);
+
+#endif // __INI_INDEX_H__
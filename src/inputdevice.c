@@ -2,11 +2,36 @@
 
 #include "devices/keyboard.h"
 #include "devices/mouse.h"
+#include "profile.h"
 
 #include <psp2kern/kernel/suspend.h>
+#include <psp2kern/kernel/sysclib.h>
 #include <psp2kern/kernel/threadmgr.h>
 #include <psp2kern/usbd.h>
 
+static volatile uint32_t reports_processed;
+static volatile uint32_t reports_skipped;
+
+// report would decode into same controlData as last one
+static int report_unchanged(InputDevice *c, int32_t count, uint32_t generation)
+{
+  if (count != c->last_length || generation != c->last_generation || memcmp(c->buffer, c->last_report, count) != 0)
+    return 0;
+
+  // mouse reports are deltas, repeated movement is new movement
+  return c->type != MOUSE || (c->buffer[1] == 0 && c->buffer[2] == 0);
+}
+
+static int report_idle(InputDevice *c, int32_t count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    if (c->buffer[i])
+      return 0;
+  }
+  return 1;
+}
+
 void on_read_data(int32_t result, int32_t count, void *arg)
 {
   // process buffer
@@ -16,6 +41,25 @@ void on_read_data(int32_t result, int32_t count, void *arg)
   {
     if (c->inited)
     {
+      uint32_t generation = profile_generation();
+      if (count > (int32_t)sizeof(c->last_report))
+        count = sizeof(c->last_report);
+
+      // active combo belongs to previous bindings
+      if (generation != c->last_generation)
+        combo_reset(&c->combo);
+
+      // keyboards resend same report every idle interval, nothing to decode then.
+      // something still held means user is there, keep system awake
+      if (report_unchanged(c, count, generation))
+      {
+        __atomic_add_fetch(&reports_skipped, 1, __ATOMIC_RELAXED);
+        if (!report_idle(c, count))
+          ksceKernelPowerTick(0);
+        usb_read(c);
+        return;
+      }
+
       int ret = 0;
       switch (c->type)
       {
@@ -29,7 +73,13 @@ void on_read_data(int32_t result, int32_t count, void *arg)
           break;
       }
       if (ret)
+      {
+        memcpy(c->last_report, c->buffer, count);
+        c->last_length     = count;
+        c->last_generation = generation;
+        __atomic_add_fetch(&reports_processed, 1, __ATOMIC_RELAXED);
         ksceKernelPowerTick(0); // cancel sleep timers.
+      }
     }
   }
 
@@ -58,6 +108,18 @@ void usb_read(InputDevice *c)
   }
 }
 
+void usb_reset_layers(InputDevice *c)
+{
+  c->layer_toggled = 0;
+  c->last_length   = 0;
+}
+
+void usb_report_stats(uint32_t *processed, uint32_t *skipped)
+{
+  *processed = __atomic_load_n(&reports_processed, __ATOMIC_RELAXED);
+  *skipped   = __atomic_load_n(&reports_skipped, __ATOMIC_RELAXED);
+}
+
 void usb_write(InputDevice *c, uint8_t *data, int len)
 {
   int ret;
@@ -1,6 +1,9 @@
 #ifndef __INPUT_DEVICE_H__
 #define __INPUT_DEVICE_H__
 
+#include "combos.h"
+#include "keystate.h"
+
 #include <psp2common/types.h>
 #include <psp2kern/kernel/debug.h>
 #include <psp2kern/usbd.h>
@@ -16,12 +19,20 @@ typedef enum
 typedef struct
 {
   uint32_t buttons;
-  uint8_t leftX;
-  uint8_t leftY;
-  uint8_t rightX;
-  uint8_t rightY;
-  uint8_t lt;
-  uint8_t rt;
+  union
+  {
+    struct
+    {
+      uint8_t leftX;
+      uint8_t leftY;
+      uint8_t rightX;
+      uint8_t rightY;
+      uint8_t lt;
+      uint8_t rt;
+      uint8_t unused; // AXIS_NONE
+    };
+    uint8_t axes[7]; // by AXIS_*
+  };
 } ControlData;
 
 typedef struct
@@ -37,12 +48,29 @@ typedef struct
   SceUID pipe_control;
   unsigned char buffer[64] __attribute__((aligned(64)));
   size_t buffer_size;
+  unsigned char last_report[64]; // last decoded report
+  int32_t last_length;           // 0 if nothing decoded yet
+  uint32_t last_generation;      // of profile it was decoded with
+  keystate_t keys;               // keyboard only
+  uint8_t layer_toggled;         // layer switched on by its toggle key, 0 for base
+  combo_state_t combo;
+  int16_t mouse_carry[2];        // Q8.8 movement not sent yet, mouse only
+  volatile uint64_t mouse_delta; // x in low and y in high word, summed since last controller read
+  volatile SceUInt64 motion_time; // of controller read that last took mouse_delta
+  volatile uint32_t motion;      // packed movement of that read, see mouse.c
+  volatile SceUInt64 report_time; // of last report with movement
+  volatile SceUInt64 delta_time;  // of first report summed into mouse_delta
+  int32_t mouse_smooth[2];       // Q8 stick movement after smoothing and decay
   int vendor;
   int product;
   uint8_t iface;
 } InputDevice;
 
 void usb_read(InputDevice *c);
+// back to base layer, next report is decoded even if it's same as last one
+void usb_reset_layers(InputDevice *c);
+// totals over all devices since module start
+void usb_report_stats(uint32_t *processed, uint32_t *skipped);
 void usb_write(InputDevice *c, uint8_t *data, int len);
 
 #endif // __INPUT_DEVICE_H__
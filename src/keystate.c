@@ -0,0 +1,73 @@
+#include "keystate.h"
+
+#include <psp2kern/kernel/sysclib.h>
+
+#define KEY_ERROR_ROLLOVER 0x01
+#define KEY_FIRST 0x04 // 0x01-0x03 are error codes, not keys
+
+#define KEY_BIT(key) (0x80000000u >> ((key) & 31))
+
+void keystate_clear(keystate_t *s)
+{
+  memset(s, 0, sizeof(keystate_t));
+}
+
+static int push(keystate_t *s, uint8_t key, uint8_t pressed)
+{
+  if ((uint16_t)(s->tail - s->head) == KEY_EVENT_QUEUE_SIZE)
+  {
+    s->dropped++;
+    return 0;
+  }
+
+  key_event_t *e = &s->events[s->tail % KEY_EVENT_QUEUE_SIZE];
+  e->key         = key;
+  e->pressed     = pressed;
+  s->tail++;
+  return 1;
+}
+
+int keystate_update(keystate_t *s, const uint8_t *report, int length)
+{
+  uint32_t keys[8];
+
+  // too many keys held, keyboard doesn't know which ones. keep last known state
+  if (length > 2 && report[2] == KEY_ERROR_ROLLOVER)
+    return 0;
+
+  memset(keys, 0, sizeof(keys));
+  for (int i = 0; i < 8; i++)
+  {
+    if ((report[0] >> i) & 1)
+      keys[KEY_LEFT_CTRL >> 5] |= KEY_BIT(KEY_LEFT_CTRL + i);
+  }
+  for (int j = 2; j < length; j++)
+  {
+    if (report[j] >= KEY_FIRST)
+      keys[report[j] >> 5] |= KEY_BIT(report[j]);
+  }
+
+  int queued = 0;
+  for (int w = 0; w < 8; w++)
+  {
+    uint32_t changed = s->keys[w] ^ keys[w];
+    while (changed)
+    {
+      int b = __builtin_clz(changed);
+      changed &= ~(0x80000000u >> b);
+      queued += push(s, (w << 5) | b, (keys[w] >> (31 - b)) & 1);
+    }
+    s->keys[w] = keys[w];
+  }
+  return queued;
+}
+
+int keystate_pop(keystate_t *s, key_event_t *e)
+{
+  if (s->head == s->tail)
+    return 0;
+
+  memcpy(e, &s->events[s->head % KEY_EVENT_QUEUE_SIZE], sizeof(key_event_t));
+  s->head++;
+  return 1;
+}
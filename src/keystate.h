@@ -0,0 +1,43 @@
+#ifndef __KEYSTATE_H__
+#define __KEYSTATE_H__
+
+#include <stdint.h>
+
+// Pressed keys of a keyboard as bitmap indexed by usb hid scancode, modifiers at 0xE0-0xE7.
+// Every report is diffed against previous state and changed keys are queued as press/release events.
+
+// power of two. 64 byte report has 62 key slots and 8 modifier bits, so one report can release
+// 62 keys, press 62 others and flip every modifier: 132 events
+#define KEY_EVENT_QUEUE_SIZE 256
+
+#define KEY_LEFT_CTRL 0xE0 // modifier bit i of report is key KEY_LEFT_CTRL + i
+
+typedef struct
+{
+  uint8_t key;
+  uint8_t pressed;
+} key_event_t;
+
+typedef struct
+{
+  uint32_t keys[8]; // key k is bit 31 - k % 32 of word k / 32, so clz gives scancode order
+  key_event_t events[KEY_EVENT_QUEUE_SIZE];
+  uint16_t head; // next to pop
+  uint16_t tail; // next to push
+  uint32_t dropped; // events lost to full queue
+} keystate_t;
+
+void keystate_clear(keystate_t *s);
+
+// queue edges between current state and boot protocol report, returns number of events queued
+int keystate_update(keystate_t *s, const uint8_t *report, int length);
+
+// oldest queued event, 0 if queue is empty
+int keystate_pop(keystate_t *s, key_event_t *e);
+
+static inline int keystate_pressed(const keystate_t *s, uint8_t key)
+{
+  return (s->keys[key >> 5] >> (31 - (key & 31))) & 1;
+}
+
+#endif // __KEYSTATE_H__
@@ -0,0 +1,357 @@
+#include "loader.h"
+
+#include "arena.h"
+#include "binconfig.h"
+#include "cache.h"
+#include "ini_index.h"
+#include "util/ini.h"
+#include "util/iostat.h"
+
+#include <psp2kern/kernel/debug.h>
+#include <psp2kern/kernel/sysclib.h>
+#include <psp2kern/kernel/threadmgr.h>
+
+#define LOADER_QUEUE_SIZE 8
+#define LOADER_POLL_INTERVAL 2000000 // us
+#define LOADER_MOUNT_RETRIES 30
+#define LOADER_MOUNT_RETRY_DELAY 500000 // us
+#define LOADER_STACK_SIZE 0x4000
+#define LOADER_PRIORITY 0xA0 // below input and ctrl threads, parsing and polling can wait
+#define STACK_PAINT 0x4B495654
+
+typedef struct
+{
+  SceUID pid;
+  char titleid[16];
+  SceUInt64 queued; // us
+} request_t;
+
+static request_t queue[LOADER_QUEUE_SIZE];
+static int queue_head;
+static int queue_count;
+static SceUID current_pid; // request being processed, 0 if cancelled
+
+static SceUID queue_mutex = -1;
+static SceUID queue_sema  = -1;
+static SceUID thread_uid  = -1;
+static volatile int running;
+static SceUInt64 start_time;
+static uint32_t *stack_base;
+static SceSize stack_size;
+static loader_callback done_callback;
+static loader_reload_callback reload_callback;
+
+typedef struct
+{
+  int exists;
+  SceIoStat stat;
+} watched_file_t;
+
+static watched_file_t watched_ini;
+static watched_file_t watched_bin;
+
+// returns 1 if file was created, removed or modified since last call
+static int file_changed(const char *path, watched_file_t *w)
+{
+  SceIoStat st;
+  int exists = (ksceIoGetstat(path, &st) >= 0);
+
+  int changed = (exists != w->exists) || (exists && !iostat_same(&st, &w->stat));
+
+  w->exists = exists;
+  if (exists)
+    memcpy(&w->stat, &st, sizeof(SceIoStat));
+
+  return changed;
+}
+
+// fill unused part of loader stack with pattern, to find out how deep it gets later
+static void paint_stack()
+{
+  SceKernelThreadInfo info;
+  memset(&info, 0, sizeof(info));
+  info.size = sizeof(info);
+  if (ksceKernelGetThreadInfo(ksceKernelGetThreadId(), &info) < 0)
+    return;
+
+  stack_base = (uint32_t *)info.stack;
+  stack_size = info.stackSize;
+
+  // leave some room below current frame
+  volatile uint32_t here;
+  uint32_t *top = (uint32_t *)&here - 64;
+  for (uint32_t *p = stack_base; p < top; p++)
+    *p = STACK_PAINT;
+}
+
+SceSize loader_stack_peak(SceSize *size)
+{
+  *size = stack_size;
+  if (!stack_base)
+    return 0;
+
+  uint32_t *end = stack_base + stack_size / sizeof(uint32_t);
+  uint32_t *p   = stack_base;
+  while (p < end && *p == STACK_PAINT)
+    p++;
+
+  return (end - p) * sizeof(uint32_t);
+}
+
+static void report_footprint()
+{
+  SceSize size;
+  SceSize peak = loader_stack_peak(&size);
+  arena_report();
+  ksceDebugPrintf("Loader stack peak %u/%u bytes\n", peak, size);
+}
+
+static void check_reload()
+{
+  // evaluate both, so that stats are updated together
+  int ini_changed = file_changed(CONFIG_INI_PATH, &watched_ini);
+  int bin_changed = file_changed(CONFIG_BIN_PATH, &watched_bin);
+
+  if (ini_changed || bin_changed)
+  {
+    cache_clear();
+
+    SceUInt64 start = ksceKernelGetSystemTimeWide();
+    reload_callback();
+    ksceDebugPrintf("Config reloaded in %llu us\n", ksceKernelGetSystemTimeWide() - start);
+    report_footprint();
+  }
+}
+
+// ini_parse_at only passes pairs of target section, which may be pattern matching titleid
+static int section_handler(void *user, const char *section, const char *name, const char *value)
+{
+  configuration *config = (configuration *)user;
+
+  config->loaded = 1;
+  bindings_apply(&config->b, name, value);
+  return 1;
+}
+
+static void load_uncached(configuration *config)
+{
+  config->loaded = 0;
+  bindings_clear(&config->b);
+
+  int ret = binconfig_load(config->titleid, &config->b);
+  if (ret >= 0)
+  {
+    config->loaded = ret;
+    return;
+  }
+
+  char section[16];
+  unsigned int offset;
+  // no such section, nothing to parse
+  if (ini_index_find(config->titleid, section, &offset) <= 0)
+    return;
+
+  int error = ini_parse_at(CONFIG_INI_PATH, section_handler, config, section, offset);
+  if (error != 0)
+  {
+    if (error < 0)
+      ksceDebugPrintf("Can't load '" CONFIG_INI_PATH "': 0x%08x\n", error);
+    else
+      ksceDebugPrintf("Can't load '" CONFIG_INI_PATH "' at %d\n", error);
+  }
+}
+
+void loader_load(configuration *config)
+{
+  if (cache_get(config))
+    return;
+
+  load_uncached(config);
+  cache_put(config);
+}
+
+// at boot driver starts before ux0 is mounted
+static int wait_for_config_dir()
+{
+  SceIoStat st;
+
+  for (int i = 0; i < LOADER_MOUNT_RETRIES && running; i++)
+  {
+    if (ksceIoGetstat(CONFIG_DIR, &st) >= 0)
+      return 1;
+    ksceKernelDelayThread(LOADER_MOUNT_RETRY_DELAY);
+  }
+
+  return 0;
+}
+
+static int loader_thread(SceSize args, void *argp)
+{
+  configuration config;
+
+  paint_stack();
+
+  if (!wait_for_config_dir())
+  {
+    if (!running)
+      return 0;
+    // keep defaults, poll picks config up if it shows up later
+    ksceDebugPrintf("No " CONFIG_DIR " after %d retries, using default config\n", LOADER_MOUNT_RETRIES);
+  }
+
+  // remember current state of files, so that only later edits trigger reload
+  file_changed(CONFIG_INI_PATH, &watched_ini);
+  file_changed(CONFIG_BIN_PATH, &watched_bin);
+
+  // replace built-in defaults with config from disk
+  reload_callback();
+  ksceDebugPrintf("Initial config active after %llu us\n", ksceKernelGetSystemTimeWide() - start_time);
+  report_footprint();
+
+  while (running)
+  {
+    SceUInt32 timeout = LOADER_POLL_INTERVAL;
+    ksceKernelWaitSema(queue_sema, 1, &timeout);
+    if (!running)
+      break;
+
+    ksceKernelLockMutex(queue_mutex, 1, NULL);
+    if (!queue_count)
+    {
+      // poll timeout or poke
+      ksceKernelUnlockMutex(queue_mutex, 1);
+      check_reload();
+      continue;
+    }
+    request_t req = queue[queue_head];
+    queue_head    = (queue_head + 1) % LOADER_QUEUE_SIZE;
+    queue_count--;
+    current_pid = req.pid;
+    ksceKernelUnlockMutex(queue_mutex, 1);
+
+    // cancelled while queued
+    if (!req.pid)
+      continue;
+
+    strncpy(config.titleid, req.titleid, sizeof(config.titleid));
+    loader_load(&config);
+
+    // callback can wait for input readers, don't hold up loader_queue meanwhile
+    ksceKernelLockMutex(queue_mutex, 1, NULL);
+    int wanted = current_pid == req.pid;
+    ksceKernelUnlockMutex(queue_mutex, 1);
+
+    if (wanted)
+      done_callback(req.pid, &config);
+
+    ksceKernelLockMutex(queue_mutex, 1, NULL);
+    current_pid = 0;
+    ksceKernelUnlockMutex(queue_mutex, 1);
+
+    if (config.loaded)
+      ksceDebugPrintf("Config for %s active after %llu us\n", req.titleid, ksceKernelGetSystemTimeWide() - req.queued);
+  }
+
+  return 0;
+}
+
+int loader_start(loader_callback callback, loader_reload_callback reload)
+{
+  done_callback   = callback;
+  reload_callback = reload;
+  start_time      = ksceKernelGetSystemTimeWide();
+  queue_head    = 0;
+  queue_count   = 0;
+  current_pid   = 0;
+
+  queue_mutex = ksceKernelCreateMutex("tvikey_loader_mutex", 0, 0, NULL);
+  if (queue_mutex < 0)
+    return queue_mutex;
+
+  queue_sema = ksceKernelCreateSema("tvikey_loader_sema", 0, 0, LOADER_QUEUE_SIZE + 1, NULL);
+  if (queue_sema < 0)
+    return queue_sema;
+
+  running    = 1;
+  thread_uid = ksceKernelCreateThread("tvikey_loader", loader_thread, LOADER_PRIORITY, LOADER_STACK_SIZE, 0, 0, NULL);
+  if (thread_uid < 0)
+  {
+    running = 0;
+    return thread_uid;
+  }
+
+  return ksceKernelStartThread(thread_uid, 0, NULL);
+}
+
+void loader_stop()
+{
+  if (thread_uid >= 0)
+  {
+    running = 0;
+    ksceKernelSignalSema(queue_sema, 1);
+    ksceKernelWaitThreadEnd(thread_uid, NULL, NULL);
+    ksceKernelDeleteThread(thread_uid);
+    thread_uid = -1;
+  }
+  if (queue_sema >= 0)
+    ksceKernelDeleteSema(queue_sema);
+  if (queue_mutex >= 0)
+    ksceKernelDeleteMutex(queue_mutex);
+  queue_sema  = -1;
+  queue_mutex = -1;
+}
+
+void loader_poke()
+{
+  if (queue_sema >= 0)
+    ksceKernelSignalSema(queue_sema, 1);
+}
+
+int loader_queue(SceUID pid, const char *titleid)
+{
+  if (thread_uid < 0)
+    return -1;
+
+  ksceKernelLockMutex(queue_mutex, 1, NULL);
+  if (queue_count == LOADER_QUEUE_SIZE)
+  {
+    ksceKernelUnlockMutex(queue_mutex, 1);
+    return -1;
+  }
+
+  request_t *req = &queue[(queue_head + queue_count) % LOADER_QUEUE_SIZE];
+  req->pid       = pid;
+  req->queued    = ksceKernelGetSystemTimeWide();
+  strncpy(req->titleid, titleid, sizeof(req->titleid));
+  req->titleid[sizeof(req->titleid) - 1] = '\0';
+  queue_count++;
+  ksceKernelUnlockMutex(queue_mutex, 1);
+
+  ksceKernelSignalSema(queue_sema, 1);
+  return 0;
+}
+
+int loader_is_current(SceUID pid)
+{
+  ksceKernelLockMutex(queue_mutex, 1, NULL);
+  int current = pid && current_pid == pid;
+  ksceKernelUnlockMutex(queue_mutex, 1);
+  return current;
+}
+
+void loader_cancel(SceUID pid)
+{
+  if (queue_mutex < 0)
+    return;
+
+  ksceKernelLockMutex(queue_mutex, 1, NULL);
+  for (int i = 0; i < queue_count; i++)
+  {
+    request_t *req = &queue[(queue_head + i) % LOADER_QUEUE_SIZE];
+    if (req->pid == pid)
+      req->pid = 0;
+  }
+  if (current_pid == pid)
+    current_pid = 0;
+  ksceKernelUnlockMutex(queue_mutex, 1);
+}
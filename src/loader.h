@@ -0,0 +1,34 @@
+#ifndef __LOADER_H__
+#define __LOADER_H__
+
+#include "config.h"
+
+#include <psp2common/types.h>
+
+// Called on loader thread once config for queued process is parsed
+typedef void (*loader_callback)(SceUID pid, const configuration *config);
+// Called on loader thread once config directory is available, and then
+// whenever tvikey.ini or tvikey.bin changes on disk
+typedef void (*loader_reload_callback)();
+
+int loader_start(loader_callback callback, loader_reload_callback reload_callback);
+void loader_stop();
+
+// check config files for changes right away instead of waiting for next poll
+void loader_poke();
+
+// queue config load for process, returns < 0 if queue is full
+int loader_queue(SceUID pid, const char *titleid);
+// forget about pending load for process that went away
+void loader_cancel(SceUID pid);
+// 1 while load for pid is being processed and wasn't cancelled,
+// callback checks it again under the lock loader_cancel callers take afterwards
+int loader_is_current(SceUID pid);
+
+// deepest loader thread stack use so far, in bytes
+SceSize loader_stack_peak(SceSize *size);
+
+// synchronously fill config for config->titleid, either from precompiled blob or from ini
+void loader_load(configuration *config);
+
+#endif // __LOADER_H__
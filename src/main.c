@@ -1,17 +1,24 @@
+#include "api.h"
+#include "arena.h"
+#include "cache.h"
 #include "config.h"
 #include "devices/keyboard.h"
 #include "devices/mouse.h"
 #include "inputdevice.h"
+#include "loader.h"
+#include "profile.h"
 #include "scancodes/scancodes.h"
-#include "util/ini.h"
 
 #include <psp2kern/ctrl.h>
+#include <psp2kern/kernel/cpu.h>
 #include <psp2kern/kernel/debug.h>
 #include <psp2kern/kernel/modulemgr.h>
 #include <psp2kern/kernel/proc_event.h>
 #include <psp2kern/kernel/suspend.h>
 #include <psp2kern/kernel/sysclib.h>
+#include <psp2kern/kernel/sysmem.h>
 #include <psp2kern/kernel/sysroot.h>
+#include <psp2kern/kernel/threadmgr.h>
 #include <psp2kern/kernel/aimgr.h>
 #include <psp2kern/usbd.h>
 #include <psp2kern/usbserv.h>
@@ -42,10 +49,6 @@ static int started = 0;
 
 static InputDevice devices[MAX_DEVICES];
 
-bindings_t bind_config;
-bindings_t last_bind_config;
-bindings_t shell_bind_config;
-
 static inline int clamp(int value, int min, int max)
 {
   if (value <= min)
@@ -67,7 +70,14 @@ static void patchControlData(int port, SceCtrlData *data, int count, uint8_t neg
     if (!devices[d].inited || !devices[d].attached)
       continue;
 
+    ControlData motion;
     ControlData *controlData = &(devices[d].controlData);
+    if (devices[d].type == MOUSE)
+    {
+      motion = *controlData;
+      Mouse_applyMotion(&devices[d], &motion);
+      controlData = &motion;
+    }
 
     if (port == 0)
     { // for port 0 use button emulation
@@ -283,6 +293,7 @@ int libtvikey_detach(int device_id)
         ksceUsbdClosePipe(devices[i].pipe_control);
       }
       devices[i].pipe_control = 0;
+      devices[i].last_length  = 0;
       status = SCE_USBD_DETACH_SUCCEEDED;
     }
   }
@@ -296,255 +307,256 @@ static int libtvikey_sysevent_handler(int resume, int eventid, void *args, void
   {
     if (ksceSblAimgrIsGenuineVITA())
       ksceUsbServMacSelect(2, 0); // re-set host mode
+
+    // config could be edited on pc while we were asleep
+    loader_poke();
   }
   return 0;
 }
 
+#define MAX_PROCESSES 8
+
+// process with its own config
 typedef struct
 {
-  int loaded;
+  SceUID pid; // 0 for free slot
   char titleid[16];
-  bindings_t b;
-} configuration;
-
-#undef BINDING
-#define BINDING(sc, code, name) {sc, name},
-
-const static struct
+  profile_t *profile;
+} process_t;
+
+// guards profile pointers below, input callbacks only see active profile
+static SceUID config_mutex;
+static profile_t *shell_profile;
+static process_t processes[MAX_PROCESSES];
+// processes sent to background, their bindings wait for resume, 0 for free slot
+static SceUID suspended[MAX_PROCESSES];
+// syscall copy of bindings, too big for syscall stack
+static bindings_t *scratch_bindings;
+
+static process_t *find_process(SceUID pid)
 {
-  KbScancode val;
-  const char *str;
-} kb_conversion[] = {
-#include "scancodes/kb_scancodes.h"
-};
+  for (int i = 0; i < MAX_PROCESSES; i++)
+  {
+    if (pid != 0 && processes[i].pid == pid)
+      return &processes[i];
+  }
+  return NULL;
+}
 
-const static struct
+static process_t *find_process_slot()
 {
-  KbScancodeMod val;
-  const char *str;
-} kb_mod_conversion[] = {
-    {KB_MODIFIER_LEFTCTRL, "KB_LEFT_CTRL"},   {KB_MODIFIER_LEFTSHIFT, "KB_LEFT_SHIFT"},
-    {KB_MODIFIER_LEFTALT, "KB_LEFT_ALT"},     {KB_MODIFIER_LEFTGUI, "KB_LEFT_GUI"},
-    {KB_MODIFIER_RIGHTCTRL, "KB_RIGHT_CTRL"}, {KB_MODIFIER_RIGHTSHIFT, "KB_RIGHT_SHIFT"},
-    {KB_MODIFIER_RIGHTALT, "KB_RIGHT_ALT"},   {KB_MODIFIER_RIGHTGUI, "KB_RIGHT_GUI"},
-};
+  for (int i = 0; i < MAX_PROCESSES; i++)
+  {
+    if (processes[i].pid == 0)
+      return &processes[i];
+  }
+  return NULL;
+}
 
-const static struct
+static SceUID *find_suspended(SceUID pid)
 {
-  MouseScancode val;
-  const char *str;
-} ms_conversion[] = {
-    {MS_SCANCODE_1, "MOUSE_1"},     {MS_SCANCODE_2, "MOUSE_2"},      {MS_SCANCODE_3, "MOUSE_3"},
-    {MS_SCANCODE_XM, "MOUSE_LEFT"}, {MS_SCANCODE_XP, "MOUSE_RIGHT"}, {MS_SCANCODE_YM, "MOUSE_UP"},
-    {MS_SCANCODE_YP, "MOUSE_DOWN"},
-};
-
-const static struct
-{
-  VitaScancode val;
-  const char *str;
-} vita_conversion[] = {
-    {V_SCANCODE_DUP, "DPAD_UP"},
-    {V_SCANCODE_DDOWN, "DPAD_DOWN"},
-    {V_SCANCODE_DLEFT, "DPAD_LEFT"},
-    {V_SCANCODE_DRIGHT, "DPAD_RIGHT"},
-    {V_SCANCODE_CROSS, "CROSS"},
-    {V_SCANCODE_SQUARE, "SQUARE"},
-    {V_SCANCODE_TRIANGLE, "TRIANGLE"},
-    {V_SCANCODE_CIRCLE, "CIRCLE"},
-    {V_SCANCODE_SELECT, "SELECT"},
-    {V_SCANCODE_START, "START"},
-    {V_SCANCODE_PS, "PS"},
-    {V_SCANCODE_L1, "L1"},
-    {V_SCANCODE_L2, "L2"},
-    {V_SCANCODE_L3, "L3"},
-    {V_SCANCODE_R1, "R1"},
-    {V_SCANCODE_R2, "R2"},
-    {V_SCANCODE_R3, "R3"},
-    {V_SCANCODE_LXM, "LEFT_ANALOG_LEFT"},
-    {V_SCANCODE_LXP, "LEFT_ANALOG_RIGHT"},
-    {V_SCANCODE_LYP, "LEFT_ANALOG_DOWN"},
-    {V_SCANCODE_LYM, "LEFT_ANALOG_UP"},
-    {V_SCANCODE_RXM, "RIGHT_ANALOG_LEFT"},
-    {V_SCANCODE_RXP, "RIGHT_ANALOG_RIGHT"},
-    {V_SCANCODE_RYP, "RIGHT_ANALOG_DOWN"},
-    {V_SCANCODE_RYM, "RIGHT_ANALOG_UP"},
-
-};
+  for (int i = 0; i < MAX_PROCESSES; i++)
+  {
+    if (suspended[i] == pid)
+      return &suspended[i];
+  }
+  return NULL;
+}
 
-VitaScancode str2enum(const char *str)
+// config_mutex must be held
+static void set_suspended(SceUID pid, int state)
 {
-  for (int i = 0; i < sizeof(vita_conversion) / sizeof(vita_conversion[0]); ++i)
+  SceUID *s = find_suspended(pid);
+  if (state && !s)
   {
-    if (strcmp(str, vita_conversion[i].str) == 0)
-    {
-      return vita_conversion[i].val;
-    }
+    s = find_suspended(0);
+    if (s)
+      *s = pid;
+  }
+  else if (!state && s)
+  {
+    *s = 0;
   }
+}
 
-  return V_SCANCODE_UNKNOWN;
+void reset_config()
+{
+  if (shell_profile)
+    profile_activate(shell_profile);
 }
 
-int atoi(const char *str)
+// built-in bindings, used until config is loaded and if there's no [shell] section
+static void default_shell_bindings(bindings_t *shell)
 {
-  int sign = 1, base = 0, i = 0;
+  bindings_clear(shell);
+  shell->mouse_sensitivity_x = 10 << 8;
+  shell->mouse_sensitivity_y = 10 << 8;
+
+  shell->kb[SC_UP_ARROW]    = V_SCANCODE_DUP;
+  shell->kb[SC_DOWN_ARROW]  = V_SCANCODE_DDOWN;
+  shell->kb[SC_LEFT_ARROW]  = V_SCANCODE_DLEFT;
+  shell->kb[SC_RIGHT_ARROW] = V_SCANCODE_DRIGHT;
+
+  shell->kb[SC_ESCAPE] = V_SCANCODE_START;
+  shell->kb[SC_F1]     = V_SCANCODE_SELECT;
+
+  shell->kb[SC_ENTER]              = V_SCANCODE_CROSS;
+  shell->kb[SC_BACKSPACE]          = V_SCANCODE_CIRCLE;
+  shell->kb[SC_SPACE]              = V_SCANCODE_TRIANGLE;
+  shell->kb_mod[KB_MOD_RIGHT_CTRL] = V_SCANCODE_SQUARE;
+
+  shell->kb[SC_END]       = V_SCANCODE_L1;
+  shell->kb[SC_PAGE_DOWN] = V_SCANCODE_R1;
+  shell->kb[SC_HOME]      = V_SCANCODE_L2;
+  shell->kb[SC_PAGE_UP]   = V_SCANCODE_R2;
+  shell->kb[SC_INSERT]    = V_SCANCODE_L3;
+  shell->kb[SC_DELETE]    = V_SCANCODE_R3;
+
+  shell->mouse[MS_SCANCODE_1]  = V_SCANCODE_R1;
+  shell->mouse[MS_SCANCODE_2]  = V_SCANCODE_L1;
+  shell->mouse[MS_SCANCODE_3]  = V_SCANCODE_TRIANGLE;
+  shell->mouse[MS_SCANCODE_XM] = V_SCANCODE_LXM;
+  shell->mouse[MS_SCANCODE_XP] = V_SCANCODE_LXP;
+  shell->mouse[MS_SCANCODE_YM] = V_SCANCODE_LYM;
+  shell->mouse[MS_SCANCODE_YP] = V_SCANCODE_LYP;
+}
 
-  while (str[i] == ' ')
-  {
-    i++;
-  }
+static void set_shell_profile(const bindings_t *b)
+{
+  profile_t *p = profile_intern(b);
+  if (!p)
+    return;
 
-  if (str[i] == '-' || str[i] == '+')
+  ksceKernelLockMutex(config_mutex, 1, NULL);
+  profile_t *old = shell_profile;
+  shell_profile  = p;
+  if (old)
   {
-    sign = 1 - 2 * (str[i++] == '-');
+    profile_replace(old, p);
+    profile_unref(old);
   }
-
-  while (str[i] >= '0' && str[i] <= '9')
+  else
   {
-    if (base > INT_MAX / 10 || (base == INT_MAX / 10 && str[i] - '0' > 7))
-    {
-      if (sign == 1)
-        return INT_MAX;
-      else
-        return INT_MIN;
-    }
-    base = 10 * base + (str[i++] - '0');
+    profile_activate(p);
   }
-  return base * sign;
+  ksceKernelUnlockMutex(config_mutex, 1);
 }
 
-static int config_handler(void *user, const char *section, const char *name, const char *value)
+static void load_shell_config()
 {
-  configuration *pconfig = (configuration *)user;
-
-  if (strcmp(section, pconfig->titleid) == 0)
-  {
-    pconfig->loaded = 1;
+  configuration config;
 
-    for (int i = 0; i < sizeof(kb_conversion) / sizeof(kb_conversion[0]); ++i)
-    {
-      if (!strcmp(name, kb_conversion[i].str))
-      {
-        VitaScancode s = str2enum(value);
-        if (s != V_SCANCODE_UNKNOWN)
-        {
-          pconfig->b.kb[kb_conversion[i].val] = s;
-        }
-      }
-    }
+  strncpy(config.titleid, "shell", 16);
 
-    for (int i = 0; i < sizeof(kb_mod_conversion) / sizeof(kb_mod_conversion[0]); ++i)
-    {
-      if (!strcmp(name, kb_mod_conversion[i].str))
-      {
-        VitaScancode s = str2enum(value);
-        if (s != V_SCANCODE_UNKNOWN)
-        {
-          pconfig->b.kb_mod[i] = s;
-        }
-      }
-    }
+  loader_load(&config);
 
-    for (int i = 0; i < sizeof(ms_conversion) / sizeof(ms_conversion[0]); ++i)
-    {
-      if (!strcmp(name, ms_conversion[i].str))
-      {
-        VitaScancode s = str2enum(value);
-        if (s != V_SCANCODE_UNKNOWN)
-        {
-          pconfig->b.mouse[ms_conversion[i].val] = s;
-        }
-      }
-    }
+  if (config.loaded)
+    ksceDebugPrintf("Config loaded for shell\n");
+  else
+    default_shell_bindings(&config.b);
 
-    if (!strcmp(name, "MS_SENSITIVITY_X"))
-    {
-      pconfig->b.mouse_sensitivity_x = atoi(value);
-    }
+  set_shell_profile(&config.b);
+}
 
-    if (!strcmp(name, "MS_SENSITIVITY_Y"))
-    {
-      pconfig->b.mouse_sensitivity_y = atoi(value);
-    }
+// takes over reference to p, config_mutex must be held
+// bindings of process in background are only kept, libtvikey_proc_start activates them
+static void set_process_profile_locked(SceUID pid, const char *titleid, profile_t *p)
+{
+  int in_front    = !find_suspended(pid);
+  process_t *proc = find_process(pid);
+  if (!proc)
+    proc = find_process_slot();
+  if (proc)
+  {
+    if (proc->profile)
+      profile_unref(proc->profile);
+    proc->pid     = pid;
+    proc->profile = p;
+    strncpy(proc->titleid, titleid, sizeof(proc->titleid));
+    if (in_front)
+      profile_activate(p);
+  }
+  else
+  {
+    ksceDebugPrintf("Too many processes with config, %s won't be restored after suspend\n", titleid);
+    if (in_front)
+      profile_activate(p);
+    profile_unref(p);
   }
-
-  return 1;
 }
 
-static SceUID last_loaded_pid;
-
-void reset_config()
+// takes over reference to p
+static void set_process_profile(SceUID pid, const char *titleid, profile_t *p)
 {
-  memcpy(&bind_config, &shell_bind_config, sizeof(bindings_t));
+  ksceKernelLockMutex(config_mutex, 1, NULL);
+  set_process_profile_locked(pid, titleid, p);
+  ksceKernelUnlockMutex(config_mutex, 1);
 }
 
-void restore_last_config()
+// runs on loader thread
+static void libtvikey_config_loaded(SceUID pid, const configuration *config)
 {
-  memcpy(&bind_config, &last_bind_config, sizeof(bindings_t));
+  if (!config->loaded)
+    return;
+
+  ksceDebugPrintf("Config loaded for %s\n", config->titleid);
+
+  profile_t *p = profile_intern(&config->b);
+  if (!p)
+    return;
+
+  // process may have exited or set its own bindings since loader checked,
+  // both cancel before releasing config_mutex. One that went to background keeps them for resume.
+  ksceKernelLockMutex(config_mutex, 1, NULL);
+  if (loader_is_current(pid))
+    set_process_profile_locked(pid, config->titleid, p);
+  else
+    profile_unref(p);
+  ksceKernelUnlockMutex(config_mutex, 1);
 }
 
-void load_shell_config()
+// runs on loader thread, after tvikey.ini or tvikey.bin changed
+static void libtvikey_config_changed()
 {
-  // fill default config
-  memset(&bind_config, 0, sizeof(bindings_t));
+  load_shell_config();
 
-  configuration config;
-  strncpy(config.titleid, "shell", 16);
+  for (int i = 0; i < MAX_PROCESSES; i++)
+  {
+    configuration config;
 
-  config.loaded = 0;
-  memset(config.b.kb, 0, 256);
-  memset(config.b.kb_mod, 0, 8);
-  memset(config.b.mouse, 0, 8);
+    ksceKernelLockMutex(config_mutex, 1, NULL);
+    SceUID pid = processes[i].pid;
+    strncpy(config.titleid, processes[i].titleid, sizeof(config.titleid));
+    ksceKernelUnlockMutex(config_mutex, 1);
 
-  int error = ini_parse("ux0:/data/tvikey.ini", config_handler, &config, "shell");
-  if (error != 0)
-  {
-    if (error < 0)
-      ksceDebugPrintf("Can't load 'ux0:/data/tvikey.ini': 0x%08x\n", error);
-    else
-      ksceDebugPrintf("Can't load 'ux0:/data/tvikey.ini' at %d\n", error);
-  }
+    if (!pid)
+      continue;
 
-  if (config.loaded)
-  {
-    ksceDebugPrintf("Config loaded for shell\n");
-    memcpy(&shell_bind_config, &(config.b), sizeof(bindings_t));
-    memcpy(&bind_config, &(config.b), sizeof(bindings_t));
-  }
-  else
-  {
-    memset(&shell_bind_config, 0, sizeof(bindings_t));
-    shell_bind_config.mouse_sensitivity_x = 10;
-    shell_bind_config.mouse_sensitivity_y = 10;
-
-    shell_bind_config.kb[SC_UP_ARROW]    = V_SCANCODE_DUP;
-    shell_bind_config.kb[SC_DOWN_ARROW]  = V_SCANCODE_DDOWN;
-    shell_bind_config.kb[SC_LEFT_ARROW]  = V_SCANCODE_DLEFT;
-    shell_bind_config.kb[SC_RIGHT_ARROW] = V_SCANCODE_DRIGHT;
-
-    shell_bind_config.kb[SC_ESCAPE] = V_SCANCODE_START;
-    shell_bind_config.kb[SC_F1]     = V_SCANCODE_SELECT;
-
-    shell_bind_config.kb[SC_ENTER]                  = V_SCANCODE_CROSS;
-    shell_bind_config.kb[SC_BACKSPACE]              = V_SCANCODE_CIRCLE;
-    shell_bind_config.kb[SC_SPACE]                  = V_SCANCODE_TRIANGLE;
-    shell_bind_config.kb_mod[KB_MODIFIER_RIGHTCTRL] = V_SCANCODE_SQUARE;
-
-    shell_bind_config.kb[SC_END]       = V_SCANCODE_L1;
-    shell_bind_config.kb[SC_PAGE_DOWN] = V_SCANCODE_R1;
-    shell_bind_config.kb[SC_HOME]      = V_SCANCODE_L2;
-    shell_bind_config.kb[SC_PAGE_UP]   = V_SCANCODE_R2;
-    shell_bind_config.kb[SC_INSERT]    = V_SCANCODE_L3;
-    shell_bind_config.kb[SC_DELETE]    = V_SCANCODE_R3;
-
-    shell_bind_config.mouse[MS_SCANCODE_1]  = V_SCANCODE_R1;
-    shell_bind_config.mouse[MS_SCANCODE_2]  = V_SCANCODE_L1;
-    shell_bind_config.mouse[MS_SCANCODE_3]  = V_SCANCODE_TRIANGLE;
-    shell_bind_config.mouse[MS_SCANCODE_XM] = V_SCANCODE_LXM;
-    shell_bind_config.mouse[MS_SCANCODE_XP] = V_SCANCODE_LXP;
-    shell_bind_config.mouse[MS_SCANCODE_YM] = V_SCANCODE_LYM;
-    shell_bind_config.mouse[MS_SCANCODE_YP] = V_SCANCODE_LYP;
-    memcpy(&bind_config, &shell_bind_config, sizeof(bindings_t));
+    loader_load(&config);
+
+    profile_t *p = config.loaded ? profile_intern(&config.b) : NULL;
+
+    ksceKernelLockMutex(config_mutex, 1, NULL);
+    process_t *proc = &processes[i];
+    // process could exit while we were loading
+    if (proc->pid == pid)
+    {
+      // title section is gone, fall back to shell bindings
+      profile_t *next = p ? p : shell_profile;
+      if (next)
+        profile_replace(proc->profile, next);
+      profile_unref(proc->profile);
+      proc->profile = p;
+      if (!p)
+        proc->pid = 0;
+    }
+    else if (p)
+    {
+      profile_unref(p);
+    }
+    ksceKernelUnlockMutex(config_mutex, 1);
+
+    ksceDebugPrintf("Config reloaded for %s\n", config.titleid);
   }
 }
 
@@ -558,72 +570,194 @@ int libtvikey_proc_create(SceUID pid, SceProcEventInvokeParam2 *a2, int a3)
   // skip loading for shell, we do that in another place
   if (strcmp(titleid,"main") == 0 ) return 0;
 
-  configuration config;
-  strncpy(config.titleid, titleid, 16);
-
-  config.loaded = 0;
-  memset(config.b.kb, 0, 256);
-  memset(config.b.kb_mod, 0, 8);
-  memset(config.b.mouse, 0, 8);
-
-  int error = ini_parse("ux0:/data/tvikey.ini", config_handler, &config, titleid);
-  if (error != 0)
-  {
-    if (error < 0)
-      ksceDebugPrintf("Can't load 'ux0:/data/tvikey.ini': 0x%08x\n", error);
-    else
-      ksceDebugPrintf("Can't load 'ux0:/data/tvikey.ini' at %d\n", error);
-  }
-
-  if (config.loaded)
-  {
-    ksceDebugPrintf("Config loaded for %s\n", titleid);
-    memcpy(&bind_config, &(config.b), sizeof(bindings_t));
-    memcpy(&last_bind_config, &(config.b), sizeof(bindings_t));
-    last_loaded_pid = pid;
-  }
-  else
-  {
-  }
+  // shell bindings stay active until loader publishes title ones
+  if (loader_queue(pid, titleid) < 0)
+    ksceDebugPrintf("Can't queue config load for %s\n", titleid);
 
   return 0;
 }
 
+// next title starts in base layer, forget last reports so it's applied right away
+static void reset_layers()
+{
+  for (int i = 0; i < MAX_DEVICES; i++)
+    usb_reset_layers(&devices[i]);
+}
+
 int libtvikey_proc_stop(SceUID pid, int event_type, SceProcEventInvokeParam1 *a3, int a4)
 {
-    if (pid != 0 && pid == last_loaded_pid && event_type == 0x1000)
+    if (event_type != 0x1000)
+        return 0;
+
+    ksceKernelLockMutex(config_mutex, 1, NULL);
+    // load still queued for it mustn't activate title bindings over shell
+    set_suspended(pid, 1);
+    if (find_process(pid))
     {
         reset_config();
+        reset_layers();
     }
+    ksceKernelUnlockMutex(config_mutex, 1);
     return 0;
 }
 
 int libtvikey_proc_start(SceUID pid, int event_type, SceProcEventInvokeParam1 *a3, int a4)
 {
-    if (pid != 0 && pid == last_loaded_pid && event_type == 0x10000)
+    if (event_type != 0x10000)
+        return 0;
+
+    ksceKernelLockMutex(config_mutex, 1, NULL);
+    set_suspended(pid, 0);
+    process_t *proc = find_process(pid);
+    if (proc)
     {
-      restore_last_config();
+      profile_activate(proc->profile);
     }
+    ksceKernelUnlockMutex(config_mutex, 1);
     return 0;
 }
 
-int libtvikey_proc_exit(SceUID pid, SceProcEventInvokeParam1 *a3, int a4)
+static void forget_process(SceUID pid)
 {
-    if (pid != 0 && pid == last_loaded_pid)
+    loader_cancel(pid);
+
+    ksceKernelLockMutex(config_mutex, 1, NULL);
+    set_suspended(pid, 0);
+    process_t *proc = find_process(pid);
+    if (proc)
     {
-        last_loaded_pid = 0;
+        profile_unref(proc->profile);
+        proc->profile = NULL;
+        proc->pid     = 0;
     }
+    ksceKernelUnlockMutex(config_mutex, 1);
+}
 
+int libtvikey_proc_exit(SceUID pid, SceProcEventInvokeParam1 *a3, int a4)
+{
+    forget_process(pid);
+    return 0;
 }
 
 int libtvikey_proc_kill(SceUID pid, SceProcEventInvokeParam1 *a3, int a4)
 {
-    if (pid != 0 && pid == last_loaded_pid)
-    {
-        last_loaded_pid = 0;
-    }
+    forget_process(pid);
+    return 0;
 }
 
+// user api, see include/tvikey.h
+
+int tvikeyGetBindings(tvikey_bindings_t *bindings)
+{
+  uint32_t state;
+
+  ENTER_SYSCALL(state);
+  ksceKernelLockMutex(config_mutex, 1, NULL);
+
+  const profile_t *p = profile_enter();
+  memcpy(scratch_bindings, &p->b, sizeof(bindings_t));
+  profile_leave(p);
+
+  int ret = api_bindings_to_user(bindings, scratch_bindings);
+
+  ksceKernelUnlockMutex(config_mutex, 1);
+  EXIT_SYSCALL(state);
+  return ret;
+}
+
+int tvikeySetBindings(const tvikey_bindings_t *bindings)
+{
+  uint32_t state;
+  char titleid[16];
+
+  ENTER_SYSCALL(state);
+  ksceKernelLockMutex(config_mutex, 1, NULL);
+
+  int ret = api_bindings_from_user(scratch_bindings, bindings);
+  if (ret < 0)
+    goto out;
+
+  profile_t *p = profile_intern(scratch_bindings);
+  if (!p)
+  {
+    ret = TVIKEY_ERROR_NO_MEMORY;
+    goto out;
+  }
+
+  SceUID pid = ksceKernelGetProcessId();
+  ksceKernelSysrootGetProcessTitleId(pid, titleid, sizeof(titleid));
+
+  // don't let pending ini load override these
+  loader_cancel(pid);
+  set_process_profile_locked(pid, titleid, p);
+  ret = 0;
+
+out:
+  ksceKernelUnlockMutex(config_mutex, 1);
+  EXIT_SYSCALL(state);
+  return ret;
+}
+
+int tvikeyResetBindings()
+{
+  uint32_t state;
+  char titleid[16];
+
+  ENTER_SYSCALL(state);
+
+  SceUID pid = ksceKernelGetProcessId();
+  ksceKernelSysrootGetProcessTitleId(pid, titleid, sizeof(titleid));
+
+  forget_process(pid);
+
+  ksceKernelLockMutex(config_mutex, 1, NULL);
+  reset_config();
+  ksceKernelUnlockMutex(config_mutex, 1);
+
+  int ret = 0;
+  if (strcmp(titleid, "main") != 0)
+    ret = loader_queue(pid, titleid);
+
+  EXIT_SYSCALL(state);
+  return ret;
+}
+
+int tvikeyGetMemoryStats(tvikey_memory_stats_t *stats)
+{
+  uint32_t state;
+  tvikey_memory_stats_t s;
+  arena_usage_t usage;
+  SceSize stack_size;
+
+  ENTER_SYSCALL(state);
+
+  arena_usage(ARENA_BUDGETS, &usage);
+  s.arena_size        = usage.size;
+  s.arena_used        = usage.used;
+  s.arena_peak        = usage.peak;
+  s.arena_failures    = usage.failures;
+  s.loader_stack_peak = loader_stack_peak(&stack_size);
+  s.loader_stack_size = stack_size;
+
+  int ret = ksceKernelMemcpyKernelToUser(stats, &s, sizeof(s));
+
+  EXIT_SYSCALL(state);
+  return ret < 0 ? ret : 0;
+}
+
+int tvikeyGetInputStats(tvikey_input_stats_t *stats)
+{
+  uint32_t state;
+  tvikey_input_stats_t s;
+
+  ENTER_SYSCALL(state);
+
+  usb_report_stats(&s.reports_processed, &s.reports_skipped);
+  int ret = ksceKernelMemcpyKernelToUser(stats, &s, sizeof(s));
+
+  EXIT_SYSCALL(state);
+  return ret < 0 ? ret : 0;
+}
 
 static SceUID proc_handler_uid;
 
@@ -639,16 +773,37 @@ static const SceProcEventHandler proc_handler = {.size           = 0x1C,
 
 int module_start(SceSize args, void *argp)
 {
+  SceUInt64 start = ksceKernelGetSystemTimeWide();
   tai_module_info_t modInfo;
   modInfo.size = sizeof(tai_module_info_t);
 
-  last_loaded_pid = 0;
-
   memset(&devices, 0, sizeof(devices));
+  memset(&processes, 0, sizeof(processes));
 
-  if (taiGetModuleInfoForKernel(KERNEL_PID, "SceCtrl", &modInfo) < 0)
+  config_mutex = ksceKernelCreateMutex("tvikey_config_mutex", 0, 0, NULL);
+  if (config_mutex < 0)
     return SCE_KERNEL_START_FAILED;
 
+  if (arena_init() < 0)
+    goto fail_mutex;
+  if (profile_init() < 0)
+    goto fail_arena;
+  cache_init();
+  scratch_bindings = arena_alloc(ARENA_SCRATCH, sizeof(bindings_t));
+  if (!scratch_bindings)
+    goto fail_arena;
+
+  // ux0 may not be mounted yet, start with built-in bindings and let loader thread read config
+  bindings_t defaults;
+  default_shell_bindings(&defaults);
+  set_shell_profile(&defaults);
+
+  int ret_loader = loader_start(libtvikey_config_loaded, libtvikey_config_changed);
+  ksceDebugPrintf("loader_start = 0x%08x\n", ret_loader);
+
+  if (taiGetModuleInfoForKernel(KERNEL_PID, "SceCtrl", &modInfo) < 0)
+    goto fail_loader;
+
   // Hook control data functions
   BIND_FUNC_EXPORT_HOOK(ksceCtrlPeekBufferPositive, KERNEL_PID, "SceCtrl", TAI_ANY_LIBRARY, 0xEA1D3A34);
   BIND_FUNC_EXPORT_HOOK(ksceCtrlReadBufferPositive, KERNEL_PID, "SceCtrl", TAI_ANY_LIBRARY, 0x9B96A1AA);
@@ -672,9 +827,6 @@ int module_start(SceSize args, void *argp)
     ksceUsbServMacSelect(2, 0);
   }
 
-  // fill default config
-  load_shell_config();
-
   // remove sony usb_charge driver that intercepts HID devices
   // do it before registering this driver so it detaches from any previously plugged devices
   int ret_drv = ksceUsbdUnregisterDriver(&libtvikeyFakeUsbchargeDriver);
@@ -687,7 +839,18 @@ int module_start(SceSize args, void *argp)
 
   proc_handler_uid = ksceKernelRegisterProcEventHandler("ztvikey_procevent", &proc_handler, 0);
 
+  ksceDebugPrintf("module_start took %llu us\n", ksceKernelGetSystemTimeWide() - start);
+
   return SCE_KERNEL_START_SUCCESS;
+
+  // loader thread uses profiles and cache, so it goes before arena
+fail_loader:
+  loader_stop();
+fail_arena:
+  arena_term();
+fail_mutex:
+  ksceKernelDeleteMutex(config_mutex);
+  return SCE_KERNEL_START_FAILED;
 }
 
 int module_stop(SceSize args, void *argp)
@@ -710,6 +873,8 @@ int module_stop(SceSize args, void *argp)
 
   ksceKernelUnregisterProcEventHandler(proc_handler_uid);
 
+  loader_stop();
+
   return SCE_KERNEL_STOP_SUCCESS;
 }
 
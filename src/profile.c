@@ -0,0 +1,179 @@
+#include "profile.h"
+
+#include "arena.h"
+
+#include <psp2kern/kernel/debug.h>
+#include <psp2kern/kernel/sysclib.h>
+#include <psp2kern/kernel/threadmgr.h>
+
+static profile_t *pool;
+static SceUID pool_mutex = -1; // serializes interning, unref is lock free
+
+// active until something is loaded, never freed
+static profile_t empty_profile = {.refs = 1};
+
+static profile_t *volatile active = &empty_profile;
+static volatile uint32_t generation;
+
+int profile_init()
+{
+  pool_mutex = ksceKernelCreateMutex("tvikey_profile_mutex", 0, 0, NULL);
+  if (pool_mutex < 0)
+    return pool_mutex;
+
+  pool = arena_alloc(ARENA_PROFILES, TVIKEY_MAX_PROFILES * sizeof(profile_t));
+  return pool ? 0 : -1;
+}
+
+static uint32_t hash_bindings(const bindings_t *b)
+{
+  const uint8_t *p = (const uint8_t *)b;
+  uint32_t h       = 2166136261u;
+
+  for (unsigned int i = 0; i < sizeof(bindings_t); i++)
+  {
+    h ^= p[i];
+    h *= 16777619u;
+  }
+
+  // 0 marks slot that isn't filled yet
+  return h ? h : 1;
+}
+
+// take reference only if profile is still alive
+static int try_ref(profile_t *p)
+{
+  int refs;
+  do
+  {
+    refs = __atomic_load_n(&p->refs, __ATOMIC_SEQ_CST);
+    if (!refs)
+      return 0;
+  } while (!__sync_bool_compare_and_swap(&p->refs, refs, refs + 1));
+  return 1;
+}
+
+static profile_t *find(const bindings_t *b, uint32_t h)
+{
+  for (int i = 0; i < TVIKEY_MAX_PROFILES; i++)
+  {
+    profile_t *p = &pool[i];
+    if (p->hash != h || !try_ref(p))
+      continue;
+    // slots are only refilled under pool_mutex, so contents can't change under us
+    if (p->hash == h && memcmp(&p->b, b, sizeof(bindings_t)) == 0)
+      return p;
+    profile_unref(p);
+  }
+  return NULL;
+}
+
+profile_t *profile_intern(const bindings_t *b)
+{
+  if (!pool)
+    return NULL;
+
+  uint32_t h = hash_bindings(b);
+
+  ksceKernelLockMutex(pool_mutex, 1, NULL);
+
+  profile_t *p = find(b, h);
+  if (p)
+  {
+    ksceKernelUnlockMutex(pool_mutex, 1);
+    return p;
+  }
+
+  for (int i = 0; i < TVIKEY_MAX_PROFILES; i++)
+  {
+    if (__sync_bool_compare_and_swap(&pool[i].refs, 0, 1))
+    {
+      p       = &pool[i];
+      p->hash = 0;
+      memcpy(&p->b, b, sizeof(bindings_t));
+      bindings_compile(b, &p->c);
+      __sync_synchronize();
+      p->hash = h;
+      break;
+    }
+  }
+
+  ksceKernelUnlockMutex(pool_mutex, 1);
+
+  if (!p)
+    ksceDebugPrintf("Out of profiles\n");
+  return p;
+}
+
+profile_t *profile_ref(profile_t *p)
+{
+  __sync_add_and_fetch(&p->refs, 1);
+  return p;
+}
+
+void profile_unref(profile_t *p)
+{
+  if (p != &empty_profile)
+    __sync_sub_and_fetch(&p->refs, 1);
+}
+
+// after swap, old profile may still be used by callback that loaded pointer before it.
+// Readers count on profile they use, so steady stream of them on new one doesn't hold writer up.
+static void wait_readers(profile_t *old)
+{
+  while (__atomic_load_n(&old->readers, __ATOMIC_SEQ_CST))
+    ksceKernelDelayThread(100);
+}
+
+void profile_activate(profile_t *p)
+{
+  // same bindings are active already, nothing to switch
+  if (__atomic_load_n(&active, __ATOMIC_SEQ_CST) == p)
+    return;
+
+  profile_ref(p);
+  profile_t *old = __atomic_exchange_n(&active, p, __ATOMIC_SEQ_CST);
+  __atomic_add_fetch(&generation, 1, __ATOMIC_SEQ_CST);
+  wait_readers(old);
+  profile_unref(old);
+}
+
+void profile_replace(profile_t *old, profile_t *new)
+{
+  if (old == new)
+    return;
+
+  profile_ref(new);
+  if (!__sync_bool_compare_and_swap(&active, old, new))
+  {
+    profile_unref(new);
+    return;
+  }
+  __atomic_add_fetch(&generation, 1, __ATOMIC_SEQ_CST);
+  wait_readers(old);
+  profile_unref(old);
+}
+
+const profile_t *profile_enter()
+{
+  for (;;)
+  {
+    profile_t *p = __atomic_load_n(&active, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&p->readers, 1, __ATOMIC_SEQ_CST);
+    // writer that swapped p out meanwhile may have seen no readers and freed it, take new one.
+    // Pool slots are never unmapped, so counting on stale one is harmless.
+    if (__atomic_load_n(&active, __ATOMIC_SEQ_CST) == p)
+      return p;
+    __atomic_sub_fetch(&p->readers, 1, __ATOMIC_SEQ_CST);
+  }
+}
+
+void profile_leave(const profile_t *p)
+{
+  __atomic_sub_fetch(&((profile_t *)p)->readers, 1, __ATOMIC_SEQ_CST);
+}
+
+uint32_t profile_generation()
+{
+  return __atomic_load_n(&generation, __ATOMIC_SEQ_CST);
+}
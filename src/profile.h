@@ -0,0 +1,46 @@
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include "actions.h"
+#include "cache.h"
+#include "config.h"
+
+// Immutable, reference counted bindings.
+// Input callbacks read active profile through single pointer, writers swap it
+// and free old profile only after its readers are done with it.
+// Identical bindings share one profile, so they can be compared by pointer.
+
+// every cache entry may hold one, rest is for processes, shell and swaps in flight
+#define TVIKEY_MAX_PROFILES (TVIKEY_CACHE_SIZE + 16)
+
+typedef struct profile
+{
+  volatile int refs;    // 0 for free pool slot
+  volatile int readers; // callbacks between profile_enter and profile_leave
+  uint32_t hash;     // of b, 0 while slot is being filled
+  bindings_t b;
+  compiled_bindings_t c;
+} profile_t;
+
+// takes pool from arena, returns < 0 if it doesn't fit
+int profile_init();
+
+// returns profile with these bindings with one more reference,
+// existing one if there is, or NULL if pool is exhausted
+profile_t *profile_intern(const bindings_t *b);
+profile_t *profile_ref(profile_t *p);
+void profile_unref(profile_t *p);
+
+// make p active, active profile holds its own reference
+void profile_activate(profile_t *p);
+// make new active only if old is active now
+void profile_replace(profile_t *old, profile_t *new);
+
+// input callbacks bracket every use of active bindings with these
+const profile_t *profile_enter();
+void profile_leave(const profile_t *p);
+
+// changes every time active profile is switched
+uint32_t profile_generation();
+
+#endif // __PROFILE_H__
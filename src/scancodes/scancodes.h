@@ -21,6 +21,19 @@ typedef enum
   KB_MODIFIER_RIGHTGUI   = (1 << 7)  // 128
 } KbScancodeMod;
 
+// modifier bit numbers, index of modifier in bindings kb_mod
+typedef enum
+{
+  KB_MOD_LEFT_CTRL,
+  KB_MOD_LEFT_SHIFT,
+  KB_MOD_LEFT_ALT,
+  KB_MOD_LEFT_GUI,
+  KB_MOD_RIGHT_CTRL,
+  KB_MOD_RIGHT_SHIFT,
+  KB_MOD_RIGHT_ALT,
+  KB_MOD_RIGHT_GUI,
+} KbModifierBit;
+
 typedef enum
 {
   MS_SCANCODE_1,
@@ -23,26 +23,86 @@ Copyright (C) 2023, Cat
 #define MAX_NAME 50
 #define INI_START_COMMENT_PREFIXES ";#"
 #define INI_MAX_LINE 200
+#define INI_READ_CHUNK 512
 
 #include <psp2kern/io/fcntl.h>
 #include <psp2kern/kernel/debug.h>
 //#include <psp2kern/kernel/sysclib.h>
 
-char *scefgets(char *s, int n, SceUID iop)
+typedef struct
 {
-  char c;
-  register char *cs;
-  cs = s;
-  int ret;
+  SceUID fd;
+  unsigned int base; // file offset of buf[0]
+  int pos;
+  int len;
+  char buf[INI_READ_CHUNK];
+} ini_reader;
 
-  while (--n > 0 && ((ret = ksceIoRead(iop, &c, 1)) > 0))
+// Parser isn't reentrant, so buffers are kept off small kernel stacks.
+static struct
+{
+  ini_reader reader;
+  char line[INI_MAX_LINE];
+  char section[MAX_SECTION];
+} buffers;
+
+static int reader_open(ini_reader *r, const char *filename, unsigned int offset)
+{
+  r->base = offset;
+  r->pos  = 0;
+  r->len  = 0;
+  r->fd   = ksceIoOpen(filename, SCE_O_RDONLY, 0600);
+  if (r->fd < 0)
+    return r->fd;
+
+  if (offset && ksceIoLseek(r->fd, offset, SCE_SEEK_SET) < 0)
+  {
+    ksceIoClose(r->fd);
+    return -1;
+  }
+
+  return 0;
+}
+
+/* fgets replacement reading file in INI_READ_CHUNK blocks instead of byte by
+   byte. Returns NULL at end of file. */
+static char *reader_gets(char *s, int n, ini_reader *r)
+{
+  char *cs = s;
+
+  while (n > 1)
   {
-    if ((*cs++ = c) == '\n')
+    if (r->pos == r->len)
+    {
+      r->base += r->len;
+      r->pos = 0;
+      r->len = ksceIoRead(r->fd, r->buf, sizeof(r->buf));
+      if (r->len <= 0)
+      {
+        r->len = 0;
+        break;
+      }
+    }
+
+    char *p   = r->buf + r->pos;
+    int avail = r->len - r->pos;
+    if (avail > n - 1)
+      avail = n - 1;
+
+    char *nl  = memchr(p, '\n', avail);
+    int count = nl ? nl - p + 1 : avail;
+
+    memcpy(cs, p, count);
+    cs += count;
+    r->pos += count;
+    n -= count;
+
+    if (nl)
       break;
   }
 
   *cs = '\0';
-  return (ret <= 0) ? NULL : s;
+  return (cs == s) ? NULL : s;
 }
 
 int _isspace(char c)
@@ -93,8 +153,13 @@ static char *strncpy0(char *dest, const char *src, size_t size)
 
 int ini_parse(const char *filename, ini_handler handler, void *user, char* target_section)
 {
-  char line[INI_MAX_LINE];
-  char section[MAX_SECTION];
+  return ini_parse_at(filename, handler, user, target_section, 0);
+}
+
+int ini_parse_at(const char *filename, ini_handler handler, void *user, char *target_section, unsigned int offset)
+{
+  char *line    = buffers.line;
+  char *section = buffers.section;
 
   memset(line, 0, INI_MAX_LINE);
   memset(section, 0, MAX_SECTION);
@@ -107,19 +172,19 @@ int ini_parse(const char *filename, ini_handler handler, void *user, char* targe
   int error  = 0;
   int found  = 0;
 
-  SceUID file;
+  ini_reader *reader = &buffers.reader;
 
-  file = ksceIoOpen(filename, SCE_O_RDONLY, 0600);
-  if (file < 0)
-    return file;
+  int ret = reader_open(reader, filename, offset);
+  if (ret < 0)
+    return ret;
 
   /* Scan through stream line by line */
-  while (scefgets(line, INI_MAX_LINE, file) != NULL)
+  while (reader_gets(line, INI_MAX_LINE, reader) != NULL)
   {
     lineno++;
 
     start = line;
-    if (lineno == 1 && (unsigned char)start[0] == 0xEF && (unsigned char)start[1] == 0xBB
+    if (lineno == 1 && offset == 0 && (unsigned char)start[0] == 0xEF && (unsigned char)start[1] == 0xBB
         && (unsigned char)start[2] == 0xBF)
     {
       start += 3;
@@ -137,7 +202,14 @@ int ini_parse(const char *filename, ini_handler handler, void *user, char* targe
       if (*end == ']')
       {
         *end = '\0';
-        strncpy0(section, start + 1, sizeof(section));
+        strncpy0(section, start + 1, MAX_SECTION);
+        if (!target_section)
+        {
+          // notify about every section when parsing whole file
+          if (!handler(user, section, NULL, NULL) && !error)
+            error = lineno;
+          continue;
+        }
         // break early if we parsed target section
         if (strcmp(section, target_section) == 0)
         {
@@ -157,7 +229,7 @@ int ini_parse(const char *filename, ini_handler handler, void *user, char* targe
     else if (*start)
     {
       // skip other sections
-      if (strcmp(section, target_section) != 0)
+      if (target_section && strcmp(section, target_section) != 0)
       {
         continue;
       }
@@ -183,6 +255,51 @@ int ini_parse(const char *filename, ini_handler handler, void *user, char* targe
     }
   }
 
-  ksceIoClose(file);
+  ksceIoClose(reader->fd);
+  return error;
+}
+
+int ini_parse_sections(const char *filename, ini_section_handler handler, void *user)
+{
+  char *line = buffers.line;
+  char *start;
+  char *end;
+  int lineno = 0;
+  int error  = 0;
+
+  ini_reader *reader = &buffers.reader;
+
+  int ret = reader_open(reader, filename, 0);
+  if (ret < 0)
+    return ret;
+
+  unsigned int line_offset = 0;
+  while (reader_gets(line, INI_MAX_LINE, reader) != NULL)
+  {
+    lineno++;
+
+    start = line;
+    if (lineno == 1 && (unsigned char)start[0] == 0xEF && (unsigned char)start[1] == 0xBB
+        && (unsigned char)start[2] == 0xBF)
+    {
+      start += 3;
+    }
+    start = lskip(rstrip(start));
+
+    if (*start == '[')
+    {
+      end = find_chars_or_comment(start + 1, "]");
+      if (*end == ']')
+      {
+        *end = '\0';
+        if (!handler(user, start + 1, line_offset) && !error)
+          error = lineno;
+      }
+    }
+
+    line_offset = reader->base + reader->pos;
+  }
+
+  ksceIoClose(reader->fd);
   return error;
 }
@@ -29,10 +29,25 @@ typedef int (*ini_handler)(void *user, const char *section, const char *name, co
    pointer as well as section, name, and value (data only valid for duration
    of handler call). Handler should return nonzero on success, zero on error.
 
+   Only pairs from target_section are reported, parsing stops after it. If
+   target_section is NULL, whole file is parsed and handler is additionally
+   called with NULL name and value at the start of every section.
+
    Returns 0 on success, line number of first error on parse error (doesn't
    stop on first error), -1 on file open error, or -2 on memory allocation
    error (only when INI_USE_STACK is zero).
 */
 int ini_parse(const char *filename, ini_handler handler, void *user, char* target_section);
 
+/* Same as ini_parse, but starts parsing at given byte offset, which should
+   point at the beginning of a line, e.g. one from ini_parse_sections. */
+int ini_parse_at(const char *filename, ini_handler handler, void *user, char *target_section, unsigned int offset);
+
+/* Typedef for prototype of section handler function. */
+typedef int (*ini_section_handler)(void *user, const char *section, unsigned int offset);
+
+/* Call handler for every "[section]" line in file with byte offset of that
+   line. Return values are the same as for ini_parse. */
+int ini_parse_sections(const char *filename, ini_section_handler handler, void *user);
+
 #endif /* INI_H */
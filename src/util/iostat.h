@@ -0,0 +1,31 @@
+#ifndef __IOSTAT_H__
+#define __IOSTAT_H__
+
+#include <psp2kern/io/stat.h>
+
+static inline int datetime_cmp(const SceDateTime *a, const SceDateTime *b)
+{
+  if (a->year != b->year)
+    return a->year < b->year ? -1 : 1;
+  if (a->month != b->month)
+    return a->month < b->month ? -1 : 1;
+  if (a->day != b->day)
+    return a->day < b->day ? -1 : 1;
+  if (a->hour != b->hour)
+    return a->hour < b->hour ? -1 : 1;
+  if (a->minute != b->minute)
+    return a->minute < b->minute ? -1 : 1;
+  if (a->second != b->second)
+    return a->second < b->second ? -1 : 1;
+  if (a->microsecond != b->microsecond)
+    return a->microsecond < b->microsecond ? -1 : 1;
+  return 0;
+}
+
+// file wasn't modified between two stats
+static inline int iostat_same(const SceIoStat *a, const SceIoStat *b)
+{
+  return a->st_size == b->st_size && datetime_cmp(&a->st_mtime, &b->st_mtime) == 0;
+}
+
+#endif // __IOSTAT_H__
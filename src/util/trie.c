@@ -0,0 +1,150 @@
+#include "trie.h"
+
+typedef struct
+{
+  int32_t value;
+  int score;
+} match_t;
+
+// more literal characters first, then pattern without trailing '*'
+#define SCORE(literals, full) ((literals) * 2 + (full))
+
+int trie_is_pattern(const char *name)
+{
+  int pattern = 0;
+
+  for (const char *s = name; *s; s++)
+  {
+    if (*s == '?')
+      pattern = 1;
+    else if (*s == '*')
+    {
+      if (s[1])
+        return -1;
+      pattern = 1;
+    }
+  }
+
+  return pattern;
+}
+
+int trie_match(const char *pattern, const char *name)
+{
+  int literals = 0;
+
+  for (; *pattern; pattern++, name++)
+  {
+    if (*pattern == '*')
+      return SCORE(literals, 0);
+    if (!*name || (*pattern != '?' && *pattern != *name))
+      return -1;
+    literals += (*pattern != '?');
+  }
+
+  return *name ? -1 : SCORE(literals, 1);
+}
+
+int trie_nodes_needed(const char *name)
+{
+  int n = 0;
+  while (name[n])
+    n++;
+  return n;
+}
+
+void trie_init(trie_t *t, trie_node_t *nodes, int capacity)
+{
+  t->nodes    = nodes;
+  t->capacity = capacity;
+  t->count    = 1;
+
+  nodes[0].child   = 0;
+  nodes[0].sibling = 0;
+  nodes[0].c       = 0;
+  nodes[0].value   = -1;
+}
+
+static int child(trie_t *t, int node, char c)
+{
+  int last = 0;
+
+  for (int i = t->nodes[node].child; i; i = t->nodes[i].sibling)
+  {
+    if (t->nodes[i].c == c)
+      return i;
+    last = i;
+  }
+
+  if (t->count == t->capacity || t->count > UINT16_MAX)
+    return -1;
+
+  int i          = t->count++;
+  trie_node_t *n = &t->nodes[i];
+  n->child       = 0;
+  n->sibling     = 0;
+  n->c           = c;
+  n->value       = -1;
+
+  if (last)
+    t->nodes[last].sibling = i;
+  else
+    t->nodes[node].child = i;
+
+  return i;
+}
+
+int trie_insert(trie_t *t, const char *pattern, int32_t value)
+{
+  int node = 0;
+
+  for (const char *s = pattern; *s; s++)
+  {
+    node = child(t, node, *s);
+    if (node < 0)
+      return -1;
+  }
+
+  if (t->nodes[node].value >= 0)
+    return 1;
+
+  t->nodes[node].value = value;
+  return 0;
+}
+
+static void consider(match_t *best, int32_t value, int score)
+{
+  if (value < 0)
+    return;
+
+  if (best->value >= 0 && (score < best->score || (score == best->score && value > best->value)))
+    return;
+
+  best->value = value;
+  best->score = score;
+}
+
+static void match(const trie_t *t, int node, const char *s, int literals, match_t *best)
+{
+  if (!*s)
+    consider(best, t->nodes[node].value, SCORE(literals, 1));
+
+  for (int i = t->nodes[node].child; i; i = t->nodes[i].sibling)
+  {
+    const trie_node_t *n = &t->nodes[i];
+
+    if (n->c == '*')
+      consider(best, n->value, SCORE(literals, 0));
+    else if (*s && (n->c == *s || n->c == '?'))
+      match(t, i, s + 1, literals + (n->c != '?'), best);
+  }
+}
+
+int32_t trie_find(const trie_t *t, const char *name)
+{
+  match_t best = {.value = -1};
+
+  if (t->count > 0)
+    match(t, 0, name, 0, &best);
+
+  return best.value;
+}
@@ -0,0 +1,43 @@
+#ifndef __TRIE_H__
+#define __TRIE_H__
+
+#include <stdint.h>
+
+// Trie of section name patterns: '?' matches any single character, '*' at the end matches any rest.
+// Nodes live in caller provided array, lookup cost depends on titleid length, not on pattern count.
+
+typedef struct
+{
+  uint16_t child;   // first child, 0 for none (root is never a child)
+  uint16_t sibling; // next child of same parent, 0 for none
+  char c;
+  int32_t value; // of pattern ending here, -1 for none
+} trie_node_t;
+
+typedef struct
+{
+  trie_node_t *nodes;
+  int count;
+  int capacity;
+} trie_t;
+
+// returns 1 for pattern, 0 for plain name, -1 for malformed pattern
+int trie_is_pattern(const char *name);
+
+// Match single pattern without trie, returns -1 if it doesn't match name,
+// otherwise score, bigger for more specific patterns
+int trie_match(const char *pattern, const char *name);
+
+// nodes needed to insert name, at most
+int trie_nodes_needed(const char *name);
+
+void trie_init(trie_t *t, trie_node_t *nodes, int capacity);
+
+// returns 0 if inserted, 1 if pattern is already there (first one is kept), < 0 if out of nodes
+int trie_insert(trie_t *t, const char *pattern, int32_t value);
+
+// Returns value of most specific pattern matching name, -1 if none matches.
+// Pattern with more literal characters wins, then one without '*', then smaller value.
+int32_t trie_find(const trie_t *t, const char *name);
+
+#endif // __TRIE_H__
@@ -0,0 +1,12 @@
+// driver paths are on ux0:, on host "ux0:/data/tvikey.ini" is "data/tvikey.ini" in current directory
+#ifndef __COMPAT_IO_H__
+#define __COMPAT_IO_H__
+
+#include <string.h>
+
+static inline const char *compat_path(const char *path)
+{
+  return strncmp(path, "ux0:/", 5) == 0 ? path + 5 : path;
+}
+
+#endif // __COMPAT_IO_H__
@@ -0,0 +1,25 @@
+// Host stand-ins for vitasdk headers, shared by tools that build driver sources.
+// Tool's own compat directory comes first in include path and replaces headers whose behavior it needs different.
+#ifndef __COMPAT_TYPES_H__
+#define __COMPAT_TYPES_H__
+
+#include <stdint.h>
+
+typedef int SceUID;
+typedef unsigned int SceSize;
+typedef unsigned int SceUInt32;
+typedef uint64_t SceUInt64;
+typedef long long SceOff;
+
+typedef struct
+{
+  unsigned short year;
+  unsigned short month;
+  unsigned short day;
+  unsigned short hour;
+  unsigned short minute;
+  unsigned short second;
+  unsigned int microsecond;
+} SceDateTime;
+
+#endif // __COMPAT_TYPES_H__
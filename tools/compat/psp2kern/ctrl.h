@@ -0,0 +1,26 @@
+// button bits actions.c needs, same values as in vitasdk
+#ifndef __COMPAT_CTRL_H__
+#define __COMPAT_CTRL_H__
+
+enum
+{
+  SCE_CTRL_SELECT   = 0x00000001,
+  SCE_CTRL_L3       = 0x00000002,
+  SCE_CTRL_R3       = 0x00000004,
+  SCE_CTRL_START    = 0x00000008,
+  SCE_CTRL_UP       = 0x00000010,
+  SCE_CTRL_RIGHT    = 0x00000020,
+  SCE_CTRL_DOWN     = 0x00000040,
+  SCE_CTRL_LEFT     = 0x00000080,
+  SCE_CTRL_LTRIGGER = 0x00000100,
+  SCE_CTRL_RTRIGGER = 0x00000200,
+  SCE_CTRL_L1       = 0x00000400,
+  SCE_CTRL_R1       = 0x00000800,
+  SCE_CTRL_TRIANGLE = 0x00001000,
+  SCE_CTRL_CIRCLE   = 0x00002000,
+  SCE_CTRL_CROSS    = 0x00004000,
+  SCE_CTRL_SQUARE   = 0x00008000,
+  SCE_CTRL_PSBUTTON = 0x00010000,
+};
+
+#endif // __COMPAT_CTRL_H__
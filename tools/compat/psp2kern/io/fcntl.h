@@ -0,0 +1,38 @@
+// host files, for the few iofilemgr calls shared sources use
+#ifndef __COMPAT_FCNTL_H__
+#define __COMPAT_FCNTL_H__
+
+#include "../../compat_io.h"
+
+#include <psp2common/types.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#define SCE_O_RDONLY O_RDONLY
+#define SCE_SEEK_SET SEEK_SET
+#define SCE_SEEK_CUR SEEK_CUR
+#define SCE_SEEK_END SEEK_END
+
+static inline SceUID ksceIoOpen(const char *file, int flags, int mode)
+{
+  int fd = open(compat_path(file), flags, mode);
+  return fd < 0 ? -1 : fd;
+}
+
+static inline int ksceIoRead(SceUID fd, void *data, SceSize size)
+{
+  return read(fd, data, size);
+}
+
+static inline SceOff ksceIoLseek(SceUID fd, SceOff offset, int whence)
+{
+  return lseek(fd, offset, whence);
+}
+
+static inline int ksceIoClose(SceUID fd)
+{
+  return close(fd);
+}
+
+#endif // __COMPAT_FCNTL_H__
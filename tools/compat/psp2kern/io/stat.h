@@ -0,0 +1,55 @@
+// host file stat, mtime in utc like vita reports it
+#ifndef __COMPAT_STAT_H__
+#define __COMPAT_STAT_H__
+
+#include "../../compat_io.h"
+
+#include <psp2common/types.h>
+
+#include <sys/stat.h>
+#include <time.h>
+
+// libc makes these macros for st_*tim.tv_sec, SceIoStat has fields of that name
+#undef st_atime
+#undef st_ctime
+#undef st_mtime
+
+typedef struct
+{
+  unsigned int st_mode;
+  unsigned int st_attr;
+  SceOff st_size;
+  SceDateTime st_ctime;
+  SceDateTime st_atime;
+  SceDateTime st_mtime;
+  unsigned int st_private[6];
+} SceIoStat;
+
+static inline void compat_datetime(SceDateTime *d, const struct timespec *ts)
+{
+  struct tm tm;
+  gmtime_r(&ts->tv_sec, &tm);
+  d->year        = tm.tm_year + 1900;
+  d->month       = tm.tm_mon + 1;
+  d->day         = tm.tm_mday;
+  d->hour        = tm.tm_hour;
+  d->minute      = tm.tm_min;
+  d->second      = tm.tm_sec;
+  d->microsecond = ts->tv_nsec / 1000;
+}
+
+static inline int ksceIoGetstat(const char *file, SceIoStat *out)
+{
+  struct stat st;
+  if (stat(compat_path(file), &st) != 0)
+    return -1;
+
+  memset(out, 0, sizeof(SceIoStat));
+  out->st_size = st.st_size;
+  compat_datetime(&out->st_ctime, &st.st_ctim);
+  compat_datetime(&out->st_atime, &st.st_atim);
+  compat_datetime(&out->st_mtime, &st.st_mtim);
+  return 0;
+}
+
+#endif // __COMPAT_STAT_H__
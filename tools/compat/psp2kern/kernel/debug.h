@@ -0,0 +1,8 @@
+#ifndef __COMPAT_DEBUG_H__
+#define __COMPAT_DEBUG_H__
+
+#include <stdio.h>
+
+#define ksceDebugPrintf(...) fprintf(stderr, __VA_ARGS__)
+
+#endif // __COMPAT_DEBUG_H__
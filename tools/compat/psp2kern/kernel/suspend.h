@@ -0,0 +1,9 @@
+#ifndef __COMPAT_SUSPEND_H__
+#define __COMPAT_SUSPEND_H__
+
+static inline int ksceKernelPowerTick(int type)
+{
+  return 0;
+}
+
+#endif // __COMPAT_SUSPEND_H__
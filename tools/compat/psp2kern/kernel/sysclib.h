@@ -0,0 +1,6 @@
+#ifndef __COMPAT_SYSCLIB_H__
+#define __COMPAT_SYSCLIB_H__
+
+#include <string.h>
+
+#endif // __COMPAT_SYSCLIB_H__
@@ -0,0 +1,44 @@
+// arena memblock comes from malloc, user memory is plain memory
+#ifndef __COMPAT_SYSMEM_H__
+#define __COMPAT_SYSMEM_H__
+
+#include <psp2common/types.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCE_KERNEL_MEMBLOCK_TYPE_KERNEL_RW 0
+
+static void *memblock;
+
+static inline SceUID ksceKernelAllocMemBlock(const char *name, SceUInt32 type, SceSize size, void *opt)
+{
+  memblock = malloc(size);
+  return memblock ? 1 : -1;
+}
+
+static inline int ksceKernelGetMemBlockBase(SceUID uid, void **base)
+{
+  *base = memblock;
+  return 0;
+}
+
+static inline int ksceKernelFreeMemBlock(SceUID uid)
+{
+  free(memblock);
+  memblock = NULL;
+  return 0;
+}
+
+static inline int ksceKernelMemcpyUserToKernel(void *dst, const void *src, SceSize len)
+{
+  memcpy(dst, src, len);
+  return 0;
+}
+
+static inline int ksceKernelMemcpyKernelToUser(void *dst, const void *src, SceSize len)
+{
+  memcpy(dst, src, len);
+  return 0;
+}
+
+#endif // __COMPAT_SYSMEM_H__
@@ -0,0 +1,78 @@
+// device code builds, but nothing is ever attached and transfers go nowhere
+#ifndef __COMPAT_USBD_H__
+#define __COMPAT_USBD_H__
+
+#include <psp2common/types.h>
+#include <stddef.h>
+
+#define SCE_USBD_DESCRIPTOR_CONFIGURATION 2
+#define SCE_USBD_DESCRIPTOR_INTERFACE 4
+#define SCE_USBD_DESCRIPTOR_ENDPOINT 5
+#define SCE_USBD_REQUEST_SET_INTERFACE 0x0B
+#define SCE_USBD_ENDPOINT_DIRECTION_BITS 0x80
+#define SCE_USBD_ENDPOINT_DIRECTION_IN 0x80
+
+typedef struct
+{
+  uint8_t bInterfaceNumber;
+  uint8_t bInterfaceClass;
+  uint8_t bInterfaceSubclass;
+  uint8_t bInterfaceProtocol;
+} SceUsbdInterfaceDescriptor;
+
+typedef struct
+{
+  uint8_t bEndpointAddress;
+  uint8_t bmAttributes;
+  uint16_t wMaxPacketSize;
+} SceUsbdEndpointDescriptor;
+
+typedef struct
+{
+  uint8_t bConfigurationValue;
+} SceUsbdConfigurationDescriptor;
+
+typedef struct
+{
+  uint8_t bmRequestType;
+  uint8_t bRequest;
+  uint16_t wValue;
+  uint16_t wIndex;
+  uint16_t wLength;
+} SceUsbdDeviceRequest;
+
+typedef void (*ksceUsbdDoneCallback)(int32_t result, int32_t count, void *arg);
+
+static inline void *ksceUsbdScanStaticDescriptor(int device_id, void *start, uint8_t type)
+{
+  return NULL;
+}
+
+static inline SceUID ksceUsbdOpenPipe(int device_id, SceUsbdEndpointDescriptor *endpoint)
+{
+  return -1;
+}
+
+static inline int ksceUsbdClosePipe(SceUID pipe)
+{
+  return 0;
+}
+
+static inline int ksceUsbdControlTransfer(SceUID pipe, const SceUsbdDeviceRequest *req, uint8_t *buffer,
+                                          ksceUsbdDoneCallback cb, void *user)
+{
+  return -1;
+}
+
+static inline int ksceUsbdInterruptTransfer(SceUID pipe, uint8_t *buffer, SceSize length, ksceUsbdDoneCallback cb,
+                                            void *user)
+{
+  return 0;
+}
+
+static inline int ksceUsbdSetConfiguration(SceUID pipe, uint8_t config, ksceUsbdDoneCallback cb, void *user)
+{
+  return -1;
+}
+
+#endif // __COMPAT_USBD_H__
@@ -0,0 +1,45 @@
+// ini.c reads from memory here, every ksceIoRead is counted as one syscall
+#ifndef __INIBENCH_COMPAT_FCNTL_H__
+#define __INIBENCH_COMPAT_FCNTL_H__
+
+#include <psp2common/types.h>
+
+#include <string.h>
+
+#define SCE_O_RDONLY 1
+#define SCE_SEEK_SET 0
+
+// file every path opens, set by inibench.c
+extern const char *bench_file;
+extern SceSize bench_file_size;
+extern SceSize bench_file_pos;
+extern unsigned long bench_reads;
+
+static inline SceUID ksceIoOpen(const char *file, int flags, int mode)
+{
+  bench_file_pos = 0;
+  return bench_file ? 1 : -1;
+}
+
+static inline int ksceIoRead(SceUID fd, void *data, SceSize size)
+{
+  bench_reads++;
+  if (size > bench_file_size - bench_file_pos)
+    size = bench_file_size - bench_file_pos;
+  memcpy(data, bench_file + bench_file_pos, size);
+  bench_file_pos += size;
+  return size;
+}
+
+static inline SceOff ksceIoLseek(SceUID fd, SceOff offset, int whence)
+{
+  bench_file_pos = offset > bench_file_size ? bench_file_size : offset;
+  return bench_file_pos;
+}
+
+static inline int ksceIoClose(SceUID fd)
+{
+  return 0;
+}
+
+#endif // __INIBENCH_COMPAT_FCNTL_H__
@@ -0,0 +1,130 @@
+// inibench - syscalls and time needed to parse tvikey.ini, by file size
+//
+// usage: inibench [iterations]
+//
+// ksceIoRead is replaced with copy from memory that counts calls, so "reads" is what
+// ini.c would issue on vita. Old scefgets read one byte per call, that's "old reads".
+// Target section is the last one in file, so ini_parse has to go through all of it.
+
+#include "util/ini.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define COUNT(a) (int)(sizeof(a) / sizeof((a)[0]))
+
+const char *bench_file;
+unsigned int bench_file_size;
+unsigned int bench_file_pos;
+unsigned long bench_reads;
+
+static const char *section_lines[] = {
+    "KB_W = LEFT_ANALOG_UP",   "KB_A = LEFT_ANALOG_LEFT",  "KB_S = LEFT_ANALOG_DOWN", "KB_D = LEFT_ANALOG_RIGHT",
+    "KB_SPACE = CROSS",        "KB_LEFT_SHIFT = CIRCLE",   "KB_E = TRIANGLE",         "KB_R = SQUARE",
+    "MOUSE_1 = R1",            "MOUSE_2 = L1",             "MS_SENSITIVITY_X = 2.5",  "; weapon wheel",
+    "KB_Q = L2 + R1",          "KB_ESCAPE = START",
+};
+
+static int pairs;
+
+static int count_pairs(void *user, const char *section, const char *name, const char *value)
+{
+  if (name)
+    pairs++;
+  return 1;
+}
+
+static int count_sections(void *user, const char *section, unsigned int offset)
+{
+  pairs++;
+  return 1;
+}
+
+// sections of 14 lines until file is size bytes long, returns number of sections
+static int generate(char *buf, int size, char *last)
+{
+  int len = 0, sections = 0;
+  int lines = COUNT(section_lines);
+
+  while (len < size - 256)
+  {
+    snprintf(last, 16, "PCSE%05d", sections++);
+    len += sprintf(buf + len, "[%s]\n", last);
+    for (int i = 0; i < lines; i++)
+      len += sprintf(buf + len, "%s\n", section_lines[i]);
+    len += sprintf(buf + len, "\n");
+  }
+
+  bench_file      = buf;
+  bench_file_size = len;
+  return sections;
+}
+
+static double now_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// average us per parse, reads of single parse go to *reads
+static double measure(int mode, char *target, int iterations, unsigned long *reads)
+{
+  double start = now_ns();
+  for (int it = 0; it < iterations; it++)
+  {
+    pairs       = 0;
+    bench_reads = 0;
+    if (mode == 0)
+      ini_parse("bench.ini", count_pairs, NULL, target);
+    else if (mode == 1)
+      ini_parse("bench.ini", count_pairs, NULL, NULL);
+    else
+      ini_parse_sections("bench.ini", count_sections, NULL);
+  }
+  *reads = bench_reads;
+  return (now_ns() - start) / iterations / 1000;
+}
+
+int main(int argc, char *argv[])
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 50;
+  if (iterations <= 0)
+  {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  const int sizes[]     = {10 * 1024, 100 * 1024, 1024 * 1024};
+  const char *modes[]   = {"last section", "whole file", "sections only"};
+  const int lines       = COUNT(section_lines);
+  static char buf[1024 * 1024 + 1024];
+  char last[16];
+
+  printf("%8s %-14s %10s %10s %10s\n", "size", "parse", "reads", "old reads", "us");
+
+  for (int s = 0; s < COUNT(sizes); s++)
+  {
+    int sections = generate(buf, sizes[s], last);
+
+    for (int m = 0; m < 3; m++)
+    {
+      unsigned long reads;
+      double us = measure(m, last, iterations, &reads);
+
+      // comment line isn't a pair
+      int expected = m == 0 ? lines - 1 : (m == 1 ? sections * (lines - 1) : sections);
+      if (pairs != expected)
+      {
+        fprintf(stderr, "error: %s of %u bytes found %d entries, expected %d\n", modes[m], bench_file_size, pairs,
+                expected);
+        return 1;
+      }
+
+      printf("%8u %-14s %10lu %10u %10.1f\n", bench_file_size, modes[m], reads, bench_file_size, us);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,35 @@
+// single threaded benchmark, mutexes do nothing
+#ifndef __KBBENCH_COMPAT_THREADMGR_H__
+#define __KBBENCH_COMPAT_THREADMGR_H__
+
+#include <psp2common/types.h>
+#include <time.h>
+
+static inline SceUID ksceKernelCreateMutex(const char *name, SceUInt32 attr, int count, void *opt)
+{
+  return 1;
+}
+
+static inline int ksceKernelLockMutex(SceUID uid, int count, unsigned int *timeout)
+{
+  return 0;
+}
+
+static inline int ksceKernelUnlockMutex(SceUID uid, int count)
+{
+  return 0;
+}
+
+static inline int ksceKernelDelayThread(SceUInt32 us)
+{
+  return 0;
+}
+
+static inline SceUInt64 ksceKernelGetSystemTimeWide()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+#endif // __KBBENCH_COMPAT_THREADMGR_H__
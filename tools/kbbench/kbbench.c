@@ -0,0 +1,368 @@
+// kbbench - cost of mapping keyboard report to bindings, per report
+//
+// usage: kbbench [iterations]
+//
+// "scan" is the old Keyboard_processReport loop, every bound key is looked up in whole report.
+// "index" is Keyboard_processReport from keyboard.c, every key in report indexes kb directly,
+// including key state, combo and layer handling it does on every report.
+// Both run on same synthetic reports through active profile and have to press same buttons.
+//
+// Second table is combo detection: "naive" checks every combo on each key press,
+// "table" is combos.c with compiled hash table, up to TVIKEY_COMBOS combos.
+
+#include "arena.h"
+#include "combos.h"
+#include "config.h"
+#include "devices/keyboard.h"
+#include "devices/process_bind.h"
+#include "profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define REPORTS 1024
+
+#define COUNT(a) (int)(sizeof(a) / sizeof((a)[0]))
+
+// next report is requested here on vita
+void usb_read(InputDevice *c)
+{
+}
+
+static uint8_t process_scan(InputDevice *c, size_t length)
+{
+  const profile_t *p  = profile_enter();
+  const bindings_t *b = &p->b;
+
+  c->controlData.buttons = 0;
+  c->controlData.leftX   = 128;
+  c->controlData.leftY   = 128;
+  c->controlData.rightX  = 128;
+  c->controlData.rightY  = 128;
+  c->controlData.lt      = 0;
+  c->controlData.rt      = 0;
+
+  for (int i = 0; i < 256; i++)
+  {
+    if (b->kb[i] != 0xFF && b->kb[i] != 0)
+    {
+      for (size_t j = 2; j < c->buffer_size; j++)
+      {
+        if (c->buffer[j] > 0 && c->buffer[j] == i)
+        {
+          processBind(&c->controlData, b, b->kb[i]);
+        }
+      }
+    }
+  }
+
+  profile_leave(p);
+  return 1;
+}
+
+static double now_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef uint8_t (*process_fn)(InputDevice *c, size_t length);
+
+static InputDevice device;
+
+static void feed(const uint8_t *report, int size)
+{
+  memcpy(device.buffer, report, size);
+  device.buffer_size = size;
+}
+
+static double measure(process_fn fn, uint8_t (*reports)[64], int size, int iterations)
+{
+  keystate_clear(&device.keys);
+  combo_reset(&device.combo);
+
+  double start = now_ns();
+  for (int it = 0; it < iterations; it++)
+  {
+    for (int r = 0; r < REPORTS; r++)
+    {
+      feed(reports[r], size);
+      fn(&device, size);
+    }
+  }
+  return (now_ns() - start) / ((double)iterations * REPORTS);
+}
+
+// both have to give same buttons for every report, opposite stick directions
+// held at once depend on order keys are looked at, so axes may differ
+static int verify(uint8_t (*reports)[64], int size)
+{
+  keystate_clear(&device.keys);
+  combo_reset(&device.combo);
+
+  for (int r = 0; r < REPORTS; r++)
+  {
+    feed(reports[r], size);
+    process_scan(&device, size);
+    uint32_t buttons = device.controlData.buttons;
+    Keyboard_processReport(&device, size);
+    if (buttons != device.controlData.buttons)
+      return 0;
+  }
+  return 1;
+}
+
+// same priority as combos.c: longest sequence, then 3 key chords, then 2 key ones
+static int naive_press(combo_state_t *s, const bindings_t *b, const keystate_t *keys, uint8_t key, SceUInt64 now)
+{
+  int used = 0;
+  for (int n = 0; n < TVIKEY_COMBOS; n++)
+  {
+    for (int i = 0; i < TVIKEY_COMBO_KEYS; i++)
+      used |= b->combos[n].value && b->combos[n].keys[i] == key;
+  }
+  if (!used || now - s->last_press > TVIKEY_COMBO_WINDOW * 1000ull)
+    s->history_len = 0;
+  s->last_press = now;
+  if (!used)
+    return 0;
+
+  if (s->history_len == TVIKEY_COMBO_KEYS)
+  {
+    memmove(s->history, s->history + 1, TVIKEY_COMBO_KEYS - 1);
+    s->history_len--;
+  }
+  s->history[s->history_len++] = key;
+
+  for (int len = s->history_len; len >= 2; len--)
+  {
+    for (int n = 0; n < TVIKEY_COMBOS; n++)
+    {
+      const tvikey_combo_t *c = &b->combos[n];
+      if (c->value && c->sequence && (len == TVIKEY_COMBO_KEYS || !c->keys[len]) && c->keys[len - 1]
+          && memcmp(c->keys, &s->history[s->history_len - len], len) == 0)
+        return n + 1;
+    }
+  }
+
+  for (int size = 3; size >= 2; size--)
+  {
+    for (int n = 0; n < TVIKEY_COMBOS; n++)
+    {
+      const tvikey_combo_t *c = &b->combos[n];
+      if (!c->value || c->sequence || !c->keys[size - 1] || c->keys[size])
+        continue;
+
+      int held = 1, has = 0;
+      for (int i = 0; i < size; i++)
+      {
+        held &= keystate_pressed(keys, c->keys[i]);
+        has |= c->keys[i] == key;
+      }
+      if (held && has)
+        return n + 1;
+    }
+  }
+  return 0;
+}
+
+static volatile uint32_t matched;
+
+static double measure_combos(int table, const bindings_t *b, const compiled_combos_t *cc, uint8_t (*reports)[64],
+                             int iterations)
+{
+  keystate_t keys;
+  combo_state_t s;
+  SceUInt64 now = 0;
+
+  keystate_clear(&keys);
+  combo_reset(&s);
+
+  double start = now_ns();
+  for (int it = 0; it < iterations; it++)
+  {
+    for (int r = 0; r < REPORTS; r++)
+    {
+      keystate_update(&keys, reports[r], 8);
+      now += 50000;
+
+      key_event_t e;
+      while (keystate_pop(&keys, &e))
+      {
+        if (!e.pressed)
+          continue;
+        if (table)
+          combo_press(&s, b, cc, &keys, e.key, now);
+        else if (naive_press(&s, b, &keys, e.key, now))
+          matched++;
+      }
+      if (table && s.active && combo_active(&s, b, &keys))
+        matched++;
+    }
+  }
+  return (now_ns() - start) / ((double)iterations * REPORTS);
+}
+
+// both ways have to find same combo on every press
+static int verify_combos(const bindings_t *b, const compiled_combos_t *cc, uint8_t (*reports)[64])
+{
+  keystate_t keys;
+  combo_state_t naive, table;
+  SceUInt64 now = 0;
+
+  keystate_clear(&keys);
+  combo_reset(&naive);
+  combo_reset(&table);
+
+  for (int r = 0; r < REPORTS; r++)
+  {
+    keystate_update(&keys, reports[r], 8);
+    now += 50000;
+
+    key_event_t e;
+    while (keystate_pop(&keys, &e))
+    {
+      if (!e.pressed)
+        continue;
+
+      table.active = 0;
+      combo_press(&table, b, cc, &keys, e.key, now);
+      int found = naive_press(&naive, b, &keys, e.key, now);
+
+      if (!found != !table.active)
+        return 0;
+      // duplicates may differ in index, not in keys
+      if (found && memcmp(&b->combos[found - 1], &b->combos[table.active - 1], TVIKEY_COMBO_KEYS + 1) != 0)
+        return 0;
+    }
+  }
+  return 1;
+}
+
+static void bench_combos(int iterations)
+{
+  static uint8_t reports[REPORTS][64];
+  const int counts[] = {1, 8, TVIKEY_COMBOS};
+
+  // few keys held, mostly from small set so combos actually match
+  memset(reports, 0, sizeof(reports));
+  for (int r = 0; r < REPORTS; r++)
+  {
+    int keys = rand() % 4;
+    for (int k = 0; k < keys; k++)
+      reports[r][2 + k] = 4 + rand() % 16;
+  }
+
+  printf("\n%6s %12s %12s\n", "combos", "naive ns", "table ns");
+
+  for (int n = 0; n < COUNT(counts); n++)
+  {
+    bindings_t b;
+    compiled_combos_t cc;
+    memset(&b, 0, sizeof(b));
+
+    for (int i = 0; i < counts[n]; i++)
+    {
+      tvikey_combo_t *c = &b.combos[i];
+      c->sequence       = i & 1;
+      c->value          = 1 + i % 25;
+      int size          = c->sequence ? 2 + i % 3 : 2 + i % 2;
+      for (int k = 0; k < size; k++)
+        c->keys[k] = 4 + (i * 7 + k * 5) % 48;
+
+      // chords are stored sorted
+      for (int k = 1; !c->sequence && k < size; k++)
+      {
+        for (int j = k; j > 0 && c->keys[j - 1] > c->keys[j]; j--)
+        {
+          uint8_t t      = c->keys[j];
+          c->keys[j]     = c->keys[j - 1];
+          c->keys[j - 1] = t;
+        }
+      }
+    }
+    combos_compile(&b, &cc);
+
+    if (!verify_combos(&b, &cc, reports))
+    {
+      fprintf(stderr, "error: combo detection disagrees with %d combos\n", counts[n]);
+      exit(1);
+    }
+
+    double naive = measure_combos(0, &b, &cc, reports, iterations);
+    double table = measure_combos(1, &b, &cc, reports, iterations);
+    printf("%6d %12.1f %12.1f\n", counts[n], naive, table);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 200;
+  if (iterations <= 0)
+  {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  static uint8_t reports[REPORTS][64];
+  const int sizes[]    = {8, 64};
+  const int bindings[] = {8, 32, 128, 255};
+
+  if (arena_init() < 0 || profile_init() < 0)
+  {
+    fprintf(stderr, "error: can't set up profile pool\n");
+    return 1;
+  }
+
+  srand(1);
+
+  printf("%6s %8s %12s %12s %8s\n", "report", "bindings", "scan ns", "index ns", "speedup");
+
+  for (int s = 0; s < COUNT(sizes); s++)
+  {
+    int size = sizes[s];
+
+    // up to 6 keys held at once, rest of report is zero like on real devices
+    memset(reports, 0, sizeof(reports));
+    for (int r = 0; r < REPORTS; r++)
+    {
+      int keys = rand() % 7;
+      for (int k = 0; k < keys && 2 + k < size; k++)
+        reports[r][2 + k] = 4 + rand() % 0x60;
+    }
+
+    for (int n = 0; n < COUNT(bindings); n++)
+    {
+      static bindings_t b;
+      bindings_clear(&b);
+      for (int k = 0; k < bindings[n]; k++)
+        b.kb[1 + (k * 37) % 255] = 1 + k % 25;
+
+      profile_t *p = profile_intern(&b);
+      if (!p)
+      {
+        fprintf(stderr, "error: can't intern bindings\n");
+        return 1;
+      }
+      profile_activate(p);
+      profile_unref(p);
+
+      if (!verify(reports, size))
+      {
+        fprintf(stderr, "error: loops disagree for %d byte reports with %d bindings\n", size, bindings[n]);
+        return 1;
+      }
+
+      double scan  = measure(process_scan, reports, size, iterations);
+      double index = measure(Keyboard_processReport, reports, size, iterations);
+
+      printf("%6d %8d %12.1f %12.1f %7.1fx\n", size, bindings[n], scan, index, scan / index);
+    }
+  }
+
+  bench_combos(iterations);
+  return 0;
+}
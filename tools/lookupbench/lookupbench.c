@@ -0,0 +1,198 @@
+// lookupbench - cost of turning one "name = value" line of tvikey.ini into binding
+//
+// usage: lookupbench [iterations]
+//
+// "linear" is the old config_handler: strcmp over whole kb_scancodes.h table in file order,
+// then modifiers and mouse, and str2enum over vita names for every match.
+// "sorted" is bindings_apply from config.c with generated, binary searched tables.
+// Both have to produce same bindings for every line.
+
+#include "config.h"
+#include "scancodes/scancodes.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define COUNT(a) (int)(sizeof(a) / sizeof((a)[0]))
+
+typedef struct
+{
+  int val;
+  const char *str;
+} old_conversion_t;
+
+#undef BINDING
+#define BINDING(sc, code, name) {sc, name},
+
+static const old_conversion_t old_kb[] = {
+#include "scancodes/kb_scancodes.h"
+};
+
+// value is modifier bit, same as index in old table
+static const old_conversion_t old_kb_mod[] = {
+    {0, "KB_LEFT_CTRL"},  {1, "KB_LEFT_SHIFT"},  {2, "KB_LEFT_ALT"},  {3, "KB_LEFT_GUI"},
+    {4, "KB_RIGHT_CTRL"}, {5, "KB_RIGHT_SHIFT"}, {6, "KB_RIGHT_ALT"}, {7, "KB_RIGHT_GUI"},
+};
+
+static const old_conversion_t old_ms[] = {
+    {MS_SCANCODE_1, "MOUSE_1"},     {MS_SCANCODE_2, "MOUSE_2"},      {MS_SCANCODE_3, "MOUSE_3"},
+    {MS_SCANCODE_XM, "MOUSE_LEFT"}, {MS_SCANCODE_XP, "MOUSE_RIGHT"}, {MS_SCANCODE_YM, "MOUSE_UP"},
+    {MS_SCANCODE_YP, "MOUSE_DOWN"},
+};
+
+static const old_conversion_t old_vita[] = {
+    {V_SCANCODE_DUP, "DPAD_UP"},
+    {V_SCANCODE_DDOWN, "DPAD_DOWN"},
+    {V_SCANCODE_DLEFT, "DPAD_LEFT"},
+    {V_SCANCODE_DRIGHT, "DPAD_RIGHT"},
+    {V_SCANCODE_CROSS, "CROSS"},
+    {V_SCANCODE_SQUARE, "SQUARE"},
+    {V_SCANCODE_TRIANGLE, "TRIANGLE"},
+    {V_SCANCODE_CIRCLE, "CIRCLE"},
+    {V_SCANCODE_SELECT, "SELECT"},
+    {V_SCANCODE_START, "START"},
+    {V_SCANCODE_PS, "PS"},
+    {V_SCANCODE_L1, "L1"},
+    {V_SCANCODE_L2, "L2"},
+    {V_SCANCODE_L3, "L3"},
+    {V_SCANCODE_R1, "R1"},
+    {V_SCANCODE_R2, "R2"},
+    {V_SCANCODE_R3, "R3"},
+    {V_SCANCODE_LXM, "LEFT_ANALOG_LEFT"},
+    {V_SCANCODE_LXP, "LEFT_ANALOG_RIGHT"},
+    {V_SCANCODE_LYP, "LEFT_ANALOG_DOWN"},
+    {V_SCANCODE_LYM, "LEFT_ANALOG_UP"},
+    {V_SCANCODE_RXM, "RIGHT_ANALOG_LEFT"},
+    {V_SCANCODE_RXP, "RIGHT_ANALOG_RIGHT"},
+    {V_SCANCODE_RYP, "RIGHT_ANALOG_DOWN"},
+    {V_SCANCODE_RYM, "RIGHT_ANALOG_UP"},
+};
+
+static int old_str2enum(const char *str)
+{
+  for (int i = 0; i < COUNT(old_vita); ++i)
+  {
+    if (strcmp(str, old_vita[i].str) == 0)
+      return old_vita[i].val;
+  }
+  return V_SCANCODE_UNKNOWN;
+}
+
+static void old_apply(bindings_t *b, const char *name, const char *value)
+{
+  for (int i = 0; i < COUNT(old_kb); ++i)
+  {
+    if (!strcmp(name, old_kb[i].str))
+    {
+      int s = old_str2enum(value);
+      if (s != V_SCANCODE_UNKNOWN)
+        b->kb[old_kb[i].val] = s;
+    }
+  }
+
+  for (int i = 0; i < COUNT(old_kb_mod); ++i)
+  {
+    if (!strcmp(name, old_kb_mod[i].str))
+    {
+      int s = old_str2enum(value);
+      if (s != V_SCANCODE_UNKNOWN)
+        b->kb_mod[old_kb_mod[i].val] = s;
+    }
+  }
+
+  for (int i = 0; i < COUNT(old_ms); ++i)
+  {
+    if (!strcmp(name, old_ms[i].str))
+    {
+      int s = old_str2enum(value);
+      if (s != V_SCANCODE_UNKNOWN)
+        b->mouse[old_ms[i].val] = s;
+    }
+  }
+}
+
+typedef struct
+{
+  const char *name;
+  const char *value;
+} line_t;
+
+#define LINES 4096
+
+static line_t lines[LINES];
+
+static double now_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double measure(int sorted, bindings_t *b, int iterations)
+{
+  double start = now_ns();
+  for (int it = 0; it < iterations; it++)
+  {
+    for (int l = 0; l < LINES; l++)
+    {
+      if (sorted)
+        bindings_apply(b, lines[l].name, lines[l].value);
+      else
+        old_apply(b, lines[l].name, lines[l].value);
+    }
+  }
+  return (now_ns() - start) / ((double)iterations * LINES);
+}
+
+int main(int argc, char *argv[])
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 200;
+  if (iterations <= 0)
+  {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  // every name config can have, KB_RESERVED is unbindable in both
+  static const char *names[COUNT(old_kb) + COUNT(old_kb_mod) + COUNT(old_ms)];
+  int count = 0;
+  for (int i = 0; i < COUNT(old_kb); i++)
+  {
+    if (strcmp(old_kb[i].str, "KB_RESERVED") != 0)
+      names[count++] = old_kb[i].str;
+  }
+  for (int i = 0; i < COUNT(old_kb_mod); i++)
+    names[count++] = old_kb_mod[i].str;
+  for (int i = 0; i < COUNT(old_ms); i++)
+    names[count++] = old_ms[i].str;
+
+  srand(1);
+  for (int l = 0; l < LINES; l++)
+  {
+    lines[l].name  = names[rand() % count];
+    lines[l].value = old_vita[rand() % COUNT(old_vita)].str;
+  }
+
+  static bindings_t linear, sorted;
+  bindings_clear(&linear);
+  bindings_clear(&sorted);
+  for (int l = 0; l < LINES; l++)
+  {
+    old_apply(&linear, lines[l].name, lines[l].value);
+    bindings_apply(&sorted, lines[l].name, lines[l].value);
+    if (memcmp(&linear, &sorted, sizeof(bindings_t)) != 0)
+    {
+      fprintf(stderr, "error: '%s = %s' gives different bindings\n", lines[l].name, lines[l].value);
+      return 1;
+    }
+  }
+
+  double linear_ns = measure(0, &linear, iterations);
+  double sorted_ns = measure(1, &sorted, iterations);
+
+  printf("%6s %12s %12s %8s\n", "names", "linear ns", "sorted ns", "speedup");
+  printf("%6d %12.1f %12.1f %7.1fx\n", count, linear_ns, sorted_ns, linear_ns / sorted_ns);
+  return 0;
+}
@@ -0,0 +1,37 @@
+// kernel mutexes are pthread ones, uid is index into table
+#ifndef __PROFSTRESS_COMPAT_THREADMGR_H__
+#define __PROFSTRESS_COMPAT_THREADMGR_H__
+
+#include <psp2common/types.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define COMPAT_MUTEXES 8
+
+static pthread_mutex_t compat_mutexes[COMPAT_MUTEXES];
+static int compat_mutex_count;
+
+static inline SceUID ksceKernelCreateMutex(const char *name, SceUInt32 attr, int count, void *opt)
+{
+  if (compat_mutex_count == COMPAT_MUTEXES)
+    return -1;
+  pthread_mutex_init(&compat_mutexes[compat_mutex_count], NULL);
+  return compat_mutex_count++;
+}
+
+static inline int ksceKernelLockMutex(SceUID uid, int count, unsigned int *timeout)
+{
+  return pthread_mutex_lock(&compat_mutexes[uid]);
+}
+
+static inline int ksceKernelUnlockMutex(SceUID uid, int count)
+{
+  return pthread_mutex_unlock(&compat_mutexes[uid]);
+}
+
+static inline int ksceKernelDelayThread(SceUInt32 us)
+{
+  return usleep(us);
+}
+
+#endif // __PROFSTRESS_COMPAT_THREADMGR_H__
@@ -0,0 +1,177 @@
+// profstress - readers and writers racing on active profile, with real profile.c
+//
+// usage: profstress [seconds] [readers]
+//
+// Readers do what input callbacks do: profile_enter, look at bindings, profile_leave.
+// Every config has all kb entries equal, so reader that sees mixed ones or profile without
+// references caught slot being freed and refilled under it.
+// Writer flips between more configs than pool has slots, like title switches under config_mutex,
+// another thread interns and drops configs like loader and cache do.
+// At the end every slot but the active one has to be free again.
+
+#include "arena.h"
+#include "profile.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CONFIGS (TVIKEY_MAX_PROFILES * 4)
+#define MAX_READERS 16
+
+static volatile int stop;
+static volatile unsigned long errors;
+static volatile unsigned long swaps;
+static volatile unsigned long interned;
+static volatile unsigned long exhausted;
+static unsigned long reads[MAX_READERS];
+
+static pthread_mutex_t config_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void make_bindings(bindings_t *b, int n)
+{
+  bindings_clear(b);
+  memset(b->kb, 1 + n % 25, sizeof(b->kb));
+  b->mouse_sensitivity_x = n;
+}
+
+static void *reader(void *arg)
+{
+  unsigned long *count = arg;
+
+  while (!__atomic_load_n(&stop, __ATOMIC_RELAXED))
+  {
+    const profile_t *p = profile_enter();
+    uint8_t first      = p->b.kb[0];
+    int bad            = __atomic_load_n(&p->refs, __ATOMIC_RELAXED) <= 0;
+    for (int i = 1; i < 256; i++)
+      bad |= p->b.kb[i] != first;
+    if (p->hash && first != 1 + p->b.mouse_sensitivity_x % 25)
+      bad = 1;
+    profile_leave(p);
+
+    if (bad)
+      __sync_add_and_fetch(&errors, 1);
+    (*count)++;
+  }
+  return NULL;
+}
+
+static void *writer(void *arg)
+{
+  unsigned int seed = 1;
+  profile_t *held   = NULL;
+  bindings_t b;
+
+  while (!__atomic_load_n(&stop, __ATOMIC_RELAXED))
+  {
+    make_bindings(&b, rand_r(&seed) % CONFIGS);
+    profile_t *p = profile_intern(&b);
+    if (!p)
+    {
+      __sync_add_and_fetch(&exhausted, 1);
+      continue;
+    }
+
+    // same as set_process_profile and libtvikey_config_changed
+    pthread_mutex_lock(&config_mutex);
+    if (held && rand_r(&seed) & 1)
+      profile_replace(held, p);
+    else
+      profile_activate(p);
+    if (held)
+      profile_unref(held);
+    held = p;
+    pthread_mutex_unlock(&config_mutex);
+
+    swaps++;
+  }
+
+  if (held)
+    profile_unref(held);
+  return NULL;
+}
+
+static void *interner(void *arg)
+{
+  unsigned int seed = 2;
+  bindings_t b;
+
+  while (!__atomic_load_n(&stop, __ATOMIC_RELAXED))
+  {
+    make_bindings(&b, rand_r(&seed) % CONFIGS);
+    profile_t *p = profile_intern(&b);
+    if (!p)
+    {
+      __sync_add_and_fetch(&exhausted, 1);
+      continue;
+    }
+    if (p->b.mouse_sensitivity_x != b.mouse_sensitivity_x)
+      __sync_add_and_fetch(&errors, 1);
+    profile_unref(p);
+    interned++;
+  }
+  return NULL;
+}
+
+// only active profile may hold slot, so all others have to fit new configs
+static int check_leaks()
+{
+  bindings_t b;
+  profile_t *held[TVIKEY_MAX_PROFILES];
+  int count = 0;
+
+  for (int i = 0; i < TVIKEY_MAX_PROFILES - 1; i++)
+  {
+    make_bindings(&b, CONFIGS + i);
+    held[count] = profile_intern(&b);
+    if (!held[count])
+      break;
+    count++;
+  }
+
+  for (int i = 0; i < count; i++)
+    profile_unref(held[i]);
+  return count == TVIKEY_MAX_PROFILES - 1;
+}
+
+int main(int argc, char *argv[])
+{
+  int seconds = argc > 1 ? atoi(argv[1]) : 2;
+  int readers = argc > 2 ? atoi(argv[2]) : 4;
+  if (seconds <= 0 || readers <= 0 || readers > MAX_READERS)
+  {
+    fprintf(stderr, "usage: %s [seconds] [readers, up to %d]\n", argv[0], MAX_READERS);
+    return 1;
+  }
+
+  if (arena_init() < 0 || profile_init() < 0)
+  {
+    fprintf(stderr, "error: can't set up profile pool\n");
+    return 1;
+  }
+
+  pthread_t threads[MAX_READERS + 2];
+  for (int i = 0; i < readers; i++)
+    pthread_create(&threads[i], NULL, reader, &reads[i]);
+  pthread_create(&threads[readers], NULL, writer, NULL);
+  pthread_create(&threads[readers + 1], NULL, interner, NULL);
+
+  sleep(seconds);
+  __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+
+  for (int i = 0; i < readers + 2; i++)
+    pthread_join(threads[i], NULL);
+
+  unsigned long total = 0;
+  for (int i = 0; i < readers; i++)
+    total += reads[i];
+
+  int leaks = !check_leaks();
+
+  printf("%d readers: %lu reads, %lu swaps, %lu interned, %lu pool exhausted, %lu bad reads, %s\n", readers, total,
+         swaps, interned, exhausted, errors, leaks ? "slots leaked" : "no leaks");
+  return errors || leaks || !swaps;
+}
@@ -0,0 +1,300 @@
+// compiler behind tvikeyc, also used by tvikeytest
+
+#include "compile.h"
+
+#include "binconfig.h"
+#include "config.h"
+#include "util/ini.h"
+#include "util/trie.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+typedef struct
+{
+  char titleid[16];
+  int loaded;
+  int pattern;
+  int order; // in ini
+  uint32_t record;
+  bindings_t b;
+} title_t;
+
+typedef struct
+{
+  title_t *titles;
+  int count;
+  int capacity;
+  title_t *current;
+  int errors;
+} compiler_t;
+
+static int compile_handler(void *user, const char *section, const char *name, const char *value)
+{
+  compiler_t *c = (compiler_t *)user;
+
+  if (!name)
+  {
+    c->current = NULL;
+
+    for (int i = 0; i < c->count; i++)
+    {
+      if (strcmp(c->titles[i].titleid, section) == 0)
+      {
+        // driver stops at first occurrence, so does compiler
+        fprintf(stderr, "warning: duplicate section [%s] ignored\n", section);
+        return 1;
+      }
+    }
+
+    if (strlen(section) >= sizeof(c->titles[0].titleid))
+    {
+      fprintf(stderr, "error: section name [%s] is too long\n", section);
+      c->errors++;
+      return 0;
+    }
+
+    int pattern = trie_is_pattern(section);
+    if (pattern < 0)
+    {
+      fprintf(stderr, "error: section [%s] may only have '*' at the end\n", section);
+      c->errors++;
+      return 0;
+    }
+
+    if (c->count == c->capacity)
+    {
+      c->capacity = c->capacity ? c->capacity * 2 : 64;
+      c->titles   = realloc(c->titles, c->capacity * sizeof(title_t));
+      if (!c->titles)
+      {
+        fprintf(stderr, "error: out of memory\n");
+        exit(1);
+      }
+    }
+
+    c->current = &c->titles[c->count++];
+    memset(c->current, 0, sizeof(title_t));
+    bindings_clear(&c->current->b);
+    strncpy(c->current->titleid, section, sizeof(c->current->titleid) - 1);
+    c->current->pattern = pattern;
+    c->current->order   = c->count - 1;
+    return 1;
+  }
+
+  if (!c->current)
+    return 1;
+
+  c->current->loaded = 1;
+
+  if (!bindings_apply(&c->current->b, name, value))
+  {
+    fprintf(stderr, "error: [%s] unknown binding '%s = %s'\n", section, name, value);
+    c->errors++;
+    return 0;
+  }
+
+  return 1;
+}
+
+// plain titles sorted by name, then patterns in ini order
+static int compare_titles(const void *a, const void *b)
+{
+  const title_t *ta = (const title_t *)a;
+  const title_t *tb = (const title_t *)b;
+
+  if (ta->pattern != tb->pattern)
+    return ta->pattern - tb->pattern;
+  if (ta->pattern)
+    return ta->order - tb->order;
+  return strcmp(ta->titleid, tb->titleid);
+}
+
+static int write_blob(const char *path, compiler_t *c, uint32_t ini_size, compile_stats_t *stats)
+{
+  qsort(c->titles, c->count, sizeof(title_t), compare_titles);
+
+  int plain = 0;
+  while (plain < c->count && !c->titles[plain].pattern)
+    plain++;
+
+  // identical sections share one record, empty ones are kept so they still shadow patterns
+  uint32_t records = 0;
+  for (int i = 0; i < c->count; i++)
+  {
+    if (!c->titles[i].loaded)
+    {
+      c->titles[i].record = BINCONFIG_NO_RECORD;
+      continue;
+    }
+
+    c->titles[i].record = records;
+    for (int j = 0; j < i; j++)
+    {
+      if (c->titles[j].loaded && memcmp(&c->titles[i].b, &c->titles[j].b, sizeof(bindings_t)) == 0)
+      {
+        c->titles[i].record = c->titles[j].record;
+        break;
+      }
+    }
+    if (c->titles[i].record == records)
+      records++;
+  }
+
+  binconfig_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic          = BINCONFIG_MAGIC;
+  header.version        = BINCONFIG_VERSION;
+  header.record_size    = sizeof(bindings_t);
+  header.count           = plain;
+  header.pattern_count   = c->count - plain;
+  header.ini_size        = ini_size;
+  header.index_offset    = sizeof(header);
+  header.patterns_offset = header.index_offset + plain * sizeof(binconfig_index_t);
+  header.records_offset  = header.index_offset + c->count * sizeof(binconfig_index_t);
+
+  FILE *f = fopen(path, "wb");
+  if (!f)
+  {
+    perror(path);
+    return 0;
+  }
+
+  fwrite(&header, sizeof(header), 1, f);
+
+  for (int i = 0; i < c->count; i++)
+  {
+    binconfig_index_t entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.titleid, c->titles[i].titleid, sizeof(entry.titleid));
+    entry.record = c->titles[i].record;
+    fwrite(&entry, sizeof(entry), 1, f);
+  }
+
+  for (uint32_t r = 0; r < records; r++)
+  {
+    for (int i = 0; i < c->count; i++)
+    {
+      if (c->titles[i].record == r)
+      {
+        fwrite(&c->titles[i].b, sizeof(bindings_t), 1, f);
+        break;
+      }
+    }
+  }
+
+  if (fclose(f) != 0)
+  {
+    perror(path);
+    return 0;
+  }
+
+  stats->titles   = plain;
+  stats->patterns = c->count - plain;
+  stats->records  = records;
+  return 1;
+}
+
+// check every title in blob against what text parser gives
+static int verify_blob(const char *ini_path, const char *bin_path)
+{
+  FILE *f = fopen(bin_path, "rb");
+  if (!f)
+  {
+    perror(bin_path);
+    return 0;
+  }
+
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+
+  uint8_t *blob = malloc(size);
+  if (!blob || fread(blob, 1, size, f) != (size_t)size)
+  {
+    fprintf(stderr, "error: can't read back %s\n", bin_path);
+    fclose(f);
+    free(blob);
+    return 0;
+  }
+  fclose(f);
+
+  const binconfig_header_t *header = (const binconfig_header_t *)blob;
+  const binconfig_index_t *index   = (const binconfig_index_t *)(blob + header->index_offset);
+  int ok                           = 1;
+
+  // patterns follow plain titles
+  for (uint32_t i = 0; i < header->count + header->pattern_count; i++)
+  {
+    configuration config;
+    memset(&config, 0, sizeof(config));
+    bindings_clear(&config.b);
+    memcpy(config.titleid, index[i].titleid, sizeof(config.titleid));
+
+    int error = ini_parse(ini_path, config_handler, &config, config.titleid);
+
+    if (index[i].record == BINCONFIG_NO_RECORD)
+    {
+      if (error < 0 || config.loaded)
+      {
+        fprintf(stderr, "error: [%s] compiled as empty, but has bindings in ini\n", config.titleid);
+        ok = 0;
+      }
+      continue;
+    }
+
+    const bindings_t *b = (const bindings_t *)(blob + header->records_offset + index[i].record * header->record_size);
+    if (error < 0 || !config.loaded || memcmp(b, &config.b, sizeof(bindings_t)) != 0)
+    {
+      fprintf(stderr, "error: [%s] compiled bindings differ from ini\n", config.titleid);
+      ok = 0;
+    }
+  }
+
+  free(blob);
+  return ok;
+}
+
+int compile_ini(const char *ini_path, const char *bin_path, compile_stats_t *stats)
+{
+  struct stat st;
+  if (stat(ini_path, &st) != 0)
+  {
+    perror(ini_path);
+    return 0;
+  }
+
+  compiler_t c;
+  memset(&c, 0, sizeof(c));
+  int ok = 0;
+
+  int error = ini_parse(ini_path, compile_handler, &c, NULL);
+  if (error < 0)
+  {
+    fprintf(stderr, "error: can't open %s\n", ini_path);
+    goto out;
+  }
+  if (error > 0 || c.errors)
+  {
+    fprintf(stderr, "%s:%d: first error, %d binding error(s)\n", ini_path, error, c.errors);
+    goto out;
+  }
+
+  // same check driver does for bindings set through syscall
+  for (int i = 0; i < c.count; i++)
+  {
+    if (!bindings_validate(&c.titles[i].b))
+    {
+      fprintf(stderr, "error: [%s] bindings rejected by driver\n", c.titles[i].titleid);
+      goto out;
+    }
+  }
+
+  ok = write_blob(bin_path, &c, st.st_size, stats) && verify_blob(ini_path, bin_path);
+
+out:
+  free(c.titles);
+  return ok;
+}
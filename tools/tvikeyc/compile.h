@@ -0,0 +1,17 @@
+#ifndef __TVIKEYC_COMPILE_H__
+#define __TVIKEYC_COMPILE_H__
+
+#include <stdint.h>
+
+typedef struct
+{
+  int titles;   // plain sections
+  int patterns; // wildcard sections
+  uint32_t records;
+} compile_stats_t;
+
+// compile ini_path into blob at bin_path and check it against ini,
+// returns 1 on success, errors go to stderr
+int compile_ini(const char *ini_path, const char *bin_path, compile_stats_t *stats);
+
+#endif // __TVIKEYC_COMPILE_H__
@@ -0,0 +1,29 @@
+// tvikeyc - compiles tvikey.ini into binary blob loaded by the driver
+//
+// usage: tvikeyc <tvikey.ini> [tvikey.bin]
+//
+// Every section is compiled with the same code driver uses, unknown bindings are reported as errors.
+// After writing, blob is checked against text parser result for every title.
+
+#include "compile.h"
+
+#include <stdio.h>
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argc > 3)
+  {
+    fprintf(stderr, "usage: %s <tvikey.ini> [tvikey.bin]\n", argv[0]);
+    return 1;
+  }
+
+  const char *ini_path = argv[1];
+  const char *bin_path = argc > 2 ? argv[2] : "tvikey.bin";
+
+  compile_stats_t stats;
+  if (!compile_ini(ini_path, bin_path, &stats))
+    return 1;
+
+  printf("%s: %d titles, %d patterns, %u unique records\n", bin_path, stats.titles, stats.patterns, stats.records);
+  return 0;
+}
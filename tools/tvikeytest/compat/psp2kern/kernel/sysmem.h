@@ -0,0 +1,56 @@
+// replaces tools/compat one: user copies are counted and can be made to fail like a bad user pointer would
+#ifndef __TVIKEYTEST_COMPAT_SYSMEM_H__
+#define __TVIKEYTEST_COMPAT_SYSMEM_H__
+
+#include <psp2common/types.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCE_KERNEL_MEMBLOCK_TYPE_KERNEL_RW 0
+
+#define COMPAT_COPY_FAULT 0x80020006
+
+extern int compat_copy_fail;  // copies left before next one faults, -1 never
+extern int compat_copy_count; // copies made so far
+
+static void *memblock;
+
+static inline SceUID ksceKernelAllocMemBlock(const char *name, SceUInt32 type, SceSize size, void *opt)
+{
+  memblock = malloc(size);
+  return memblock ? 1 : -1;
+}
+
+static inline int ksceKernelGetMemBlockBase(SceUID uid, void **base)
+{
+  *base = memblock;
+  return 0;
+}
+
+static inline int ksceKernelFreeMemBlock(SceUID uid)
+{
+  free(memblock);
+  memblock = NULL;
+  return 0;
+}
+
+static inline int compat_copy(void *dst, const void *src, SceSize len)
+{
+  compat_copy_count++;
+  if (compat_copy_fail >= 0 && compat_copy_fail-- == 0)
+    return (int)COMPAT_COPY_FAULT;
+  memcpy(dst, src, len);
+  return 0;
+}
+
+static inline int ksceKernelMemcpyUserToKernel(void *dst, const void *src, SceSize len)
+{
+  return compat_copy(dst, src, len);
+}
+
+static inline int ksceKernelMemcpyKernelToUser(void *dst, const void *src, SceSize len)
+{
+  return compat_copy(dst, src, len);
+}
+
+#endif // __TVIKEYTEST_COMPAT_SYSMEM_H__
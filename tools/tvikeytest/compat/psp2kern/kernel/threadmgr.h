@@ -0,0 +1,35 @@
+// tests run on one thread, mutexes do nothing and time moves only when test says so
+#ifndef __TVIKEYTEST_COMPAT_THREADMGR_H__
+#define __TVIKEYTEST_COMPAT_THREADMGR_H__
+
+#include <psp2common/types.h>
+
+extern SceUInt64 compat_time; // us
+
+static inline SceUID ksceKernelCreateMutex(const char *name, SceUInt32 attr, int count, void *opt)
+{
+  return 1;
+}
+
+static inline int ksceKernelLockMutex(SceUID uid, int count, unsigned int *timeout)
+{
+  return 0;
+}
+
+static inline int ksceKernelUnlockMutex(SceUID uid, int count)
+{
+  return 0;
+}
+
+static inline int ksceKernelDelayThread(SceUInt32 us)
+{
+  compat_time += us;
+  return 0;
+}
+
+static inline SceUInt64 ksceKernelGetSystemTimeWide()
+{
+  return compat_time;
+}
+
+#endif // __TVIKEYTEST_COMPAT_THREADMGR_H__
@@ -0,0 +1,42 @@
+#ifndef __TVIKEYTEST_TEST_H__
+#define __TVIKEYTEST_TEST_H__
+
+#include "config.h"
+
+#include <psp2common/types.h>
+#include <stdio.h>
+
+extern int test_failures;
+extern SceUInt64 compat_time;
+
+#define COUNT(a) (int)(sizeof(a) / sizeof((a)[0]))
+
+#define CHECK(cond)                                                                                                    \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (!(cond))                                                                                                       \
+    {                                                                                                                  \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond);                                                       \
+      test_failures++;                                                                                                 \
+    }                                                                                                                  \
+  } while (0)
+
+// make bindings active profile, like set_process_profile does
+void test_activate(const bindings_t *b);
+
+// suites run in scratch directory, driver's ux0:/data is data/ there
+void test_write(const char *path, const char *text);
+void test_touch(const char *path, long mtime);
+
+// one per test_*.c
+void test_binconfig();
+void test_bindings();
+void test_combos();
+void test_curves();
+void test_keystate();
+void test_layers();
+void test_lists();
+void test_mouse();
+void test_patterns();
+
+#endif // __TVIKEYTEST_TEST_H__
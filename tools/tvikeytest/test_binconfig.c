@@ -0,0 +1,118 @@
+// tvikey.bin from tvikeyc's compiler, read back by binconfig_load like loader does
+
+#include "test.h"
+
+#include "../tvikeyc/compile.h"
+#include "binconfig.h"
+#include "util/ini.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define INI_FILE "data/tvikey.ini"
+#define BIN_FILE "data/tvikey.bin"
+#define INI_TIME 1700000000L
+
+static const char ini[] = "[shell]\n"
+                          "KB_A = CROSS\n"
+                          "\n"
+                          "[PCSE00001]\n"
+                          "KB_A = CIRCLE\n"
+                          "\n"
+                          "[PCSE0000?]\n"
+                          "KB_A = SQUARE\n"
+                          "KB_B = L2 + R1\n"
+                          "\n"
+                          "[PCS?00001]\n"
+                          "KB_A = TRIANGLE\n"
+                          "\n"
+                          "[PCSE*]\n"
+                          "KB_A = L1\n"
+                          "MS_SENSITIVITY_X = 2.5\n"
+                          "\n"
+                          "[PCS*]\n"
+                          "KB_A = R1\n"
+                          "\n"
+                          "; shadows [PCS*] without bindings of its own\n"
+                          "[PCSB00002]\n";
+
+// blob newer than ini, like after running tvikeyc
+static void compile()
+{
+  compile_stats_t stats;
+  test_write(INI_FILE, ini);
+  test_touch(INI_FILE, INI_TIME);
+  CHECK(compile_ini(INI_FILE, BIN_FILE, &stats));
+  CHECK(stats.titles == 3 && stats.patterns == 4);
+  test_touch(BIN_FILE, INI_TIME + 100);
+}
+
+// driver's result for titleid has to be what text parser gives for section, NULL for nothing
+static void check_title(const char *titleid, const char *section)
+{
+  static bindings_t b;
+  static configuration config;
+
+  bindings_clear(&b);
+  int ret = binconfig_load(titleid, &b);
+  if (!section)
+  {
+    CHECK(ret == 0);
+    return;
+  }
+
+  memset(&config, 0, sizeof(config));
+  bindings_clear(&config.b);
+  strncpy(config.titleid, section, sizeof(config.titleid));
+  CHECK(ini_parse(CONFIG_INI_PATH, config_handler, &config, config.titleid) == 0);
+  CHECK(config.loaded);
+
+  CHECK(ret == 1);
+  CHECK(memcmp(&b, &config.b, sizeof(bindings_t)) == 0);
+}
+
+static void test_titles()
+{
+  compile();
+
+  check_title("shell", "shell");
+  check_title("PCSE00001", "PCSE00001");
+  check_title("PCSE00002", "PCSE0000?");
+  check_title("PCSF00001", "PCS?00001");
+  check_title("PCSE12345", "PCSE*");
+  check_title("PCSA12345", "PCS*");
+  check_title("PCSB00002", NULL);
+  check_title("NPXS10000", NULL);
+}
+
+// blob older than ini, or from ini of other size, isn't used
+static void test_stale()
+{
+  static bindings_t b;
+
+  compile();
+  CHECK(binconfig_load("PCSE00001", &b) == 1);
+
+  test_touch(INI_FILE, INI_TIME + 200);
+  CHECK(binconfig_load("PCSE00001", &b) < 0);
+
+  // edited ini with its mtime put back
+  char edited[sizeof(ini) + 32];
+  snprintf(edited, sizeof(edited), "; edited\n%s", ini);
+  test_write(INI_FILE, edited);
+  test_touch(INI_FILE, INI_TIME);
+  CHECK(binconfig_load("PCSE00001", &b) < 0);
+
+  compile();
+  CHECK(binconfig_load("PCSE00001", &b) == 1);
+
+  unlink(BIN_FILE);
+  CHECK(binconfig_load("PCSE00001", &b) < 0);
+}
+
+void test_binconfig()
+{
+  test_titles();
+  test_stale();
+}
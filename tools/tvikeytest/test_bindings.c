@@ -0,0 +1,150 @@
+// bindings_validate and syscall copies of tvikeyGetBindings/tvikeySetBindings
+
+#include "test.h"
+
+#include "api.h"
+#include "scancodes/scancodes.h"
+
+#include <psp2kern/kernel/sysmem.h>
+#include <string.h>
+
+int compat_copy_fail = -1;
+int compat_copy_count;
+
+static void reset_copies()
+{
+  compat_copy_fail  = -1;
+  compat_copy_count = 0;
+}
+
+static void test_validate()
+{
+  static bindings_t b;
+
+  bindings_clear(&b);
+  CHECK(b.size == sizeof(bindings_t));
+  CHECK(bindings_validate(&b));
+
+  // every vita input, in every table that's checked
+  for (int v = V_SCANCODE_DUP; v <= V_SCANCODE_PS; v++)
+  {
+    bindings_clear(&b);
+    b.kb[v]                           = v;
+    b.kb_mod[v % 8]                   = v;
+    b.mouse[v % 8]                    = v;
+    b.layers[1][255 - v]              = v;
+    b.combos[v % TVIKEY_COMBOS].value = v;
+    CHECK(bindings_validate(&b));
+  }
+
+  uint8_t *tables[] = {&b.kb[SC_A],        &b.kb_mod[7],     &b.mouse[7],
+                       &b.layers[0][SC_Z], &b.layers[1][255], &b.combos[TVIKEY_COMBOS - 1].value};
+  for (unsigned int t = 0; t < sizeof(tables) / sizeof(tables[0]); t++)
+  {
+    bindings_clear(&b);
+    *tables[t] = V_SCANCODE_PS + 1;
+    CHECK(!bindings_validate(&b));
+    *tables[t] = V_SCANCODE_UNKNOWN;
+    CHECK(!bindings_validate(&b));
+    *tables[t] = TVIKEY_LIST | 0x7F; // empty list at the very end
+    CHECK(!bindings_validate(&b));
+  }
+}
+
+static void test_validate_lists()
+{
+  static bindings_t b;
+
+  bindings_clear(&b);
+  CHECK(bindings_apply(&b, "KB_Q", "L2 + R1"));
+  CHECK(b.kb[SC_Q] == (TVIKEY_LIST | 0));
+  CHECK(b.lists[0] == V_SCANCODE_L2 && b.lists[1] == V_SCANCODE_R1 && b.lists[2] == 0);
+  CHECK(bindings_validate(&b));
+
+  // longest list there can be, then one more than that
+  bindings_clear(&b);
+  memset(b.lists, V_SCANCODE_CROSS, TVIKEY_LIST_MAX);
+  b.kb[SC_Q] = TVIKEY_LIST | 0;
+  CHECK(bindings_validate(&b));
+  b.lists[TVIKEY_LIST_MAX] = V_SCANCODE_CROSS;
+  CHECK(!bindings_validate(&b));
+
+  // unknown input inside list
+  bindings_clear(&b);
+  b.lists[0] = V_SCANCODE_CROSS;
+  b.lists[1] = V_SCANCODE_PS + 1;
+  b.kb[SC_Q] = TVIKEY_LIST | 0;
+  CHECK(!bindings_validate(&b));
+
+  // list without terminator before end of lists
+  bindings_clear(&b);
+  memset(&b.lists[sizeof(b.lists) - 2], V_SCANCODE_CROSS, 2);
+  b.kb[SC_Q] = TVIKEY_LIST | (sizeof(b.lists) - 2);
+  CHECK(!bindings_validate(&b));
+}
+
+static void test_from_user()
+{
+  static bindings_t user, b;
+
+  // size is checked before anything else is read
+  bindings_clear(&user);
+  reset_copies();
+  user.size = sizeof(bindings_t) - 1;
+  CHECK(api_bindings_from_user(&b, &user) == TVIKEY_ERROR_SIZE_MISMATCH);
+  CHECK(compat_copy_count == 1);
+  user.size = 0;
+  CHECK(api_bindings_from_user(&b, &user) == TVIKEY_ERROR_SIZE_MISMATCH);
+  user.size = sizeof(bindings_t) + 4;
+  CHECK(api_bindings_from_user(&b, &user) == TVIKEY_ERROR_SIZE_MISMATCH);
+
+  bindings_clear(&user);
+  user.kb[SC_SPACE] = V_SCANCODE_CROSS;
+  memset(&b, 0xAA, sizeof(b));
+  CHECK(api_bindings_from_user(&b, &user) == 0);
+  CHECK(memcmp(&b, &user, sizeof(b)) == 0);
+
+  user.kb[SC_SPACE] = V_SCANCODE_UNKNOWN;
+  CHECK(api_bindings_from_user(&b, &user) == TVIKEY_ERROR_INVALID_BINDINGS);
+
+  // faults are passed on, from either copy
+  bindings_clear(&user);
+  for (int i = 0; i < 2; i++)
+  {
+    reset_copies();
+    compat_copy_fail = i;
+    CHECK(api_bindings_from_user(&b, &user) == (int)COMPAT_COPY_FAULT);
+  }
+  reset_copies();
+}
+
+static void test_to_user()
+{
+  static bindings_t b, user;
+
+  bindings_clear(&b);
+  b.kb[SC_ENTER] = V_SCANCODE_CROSS;
+
+  // mismatch leaves user struct alone
+  memset(&user, 0x55, sizeof(user));
+  user.size = sizeof(bindings_t) - 4;
+  CHECK(api_bindings_to_user(&user, &b) == TVIKEY_ERROR_SIZE_MISMATCH);
+  CHECK(user.size == sizeof(bindings_t) - 4 && user.kb[SC_ENTER] == 0x55);
+
+  user.size = sizeof(bindings_t);
+  CHECK(api_bindings_to_user(&user, &b) == 0);
+  CHECK(memcmp(&user, &b, sizeof(b)) == 0);
+
+  reset_copies();
+  compat_copy_fail = 0;
+  CHECK(api_bindings_to_user(&user, &b) == (int)COMPAT_COPY_FAULT);
+  reset_copies();
+}
+
+void test_bindings()
+{
+  test_validate();
+  test_validate_lists();
+  test_from_user();
+  test_to_user();
+}
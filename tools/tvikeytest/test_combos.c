@@ -0,0 +1,212 @@
+// chords and sequences through on_read_data, like usb callback would
+
+#include "test.h"
+
+#include "inputdevice.h"
+#include "scancodes/scancodes.h"
+
+#include <psp2kern/ctrl.h>
+#include <string.h>
+
+void on_read_data(int32_t result, int32_t count, void *arg);
+
+static bindings_t b;
+static InputDevice kb;
+
+static void setup()
+{
+  bindings_clear(&b);
+  b.kb[SC_A] = V_SCANCODE_CROSS;
+  b.kb[SC_B] = V_SCANCODE_CIRCLE;
+
+  memset(&kb, 0, sizeof(kb));
+  kb.type        = KEYBOARD;
+  kb.inited      = 1;
+  kb.buffer_size = 8;
+  keystate_clear(&kb.keys);
+  combo_reset(&kb.combo);
+}
+
+static void combo(int n, int sequence, uint8_t value, uint8_t key1, uint8_t key2)
+{
+  b.combos[n].keys[0]  = key1;
+  b.combos[n].keys[1]  = key2;
+  b.combos[n].sequence = sequence;
+  b.combos[n].value    = value;
+}
+
+// boot report with modifier byte and up to 2 keys, ms after previous one
+static void report(int ms, uint8_t mods, uint8_t key1, uint8_t key2)
+{
+  memset(kb.buffer, 0, 8);
+  kb.buffer[0] = mods;
+  kb.buffer[2] = key1;
+  kb.buffer[3] = key2;
+  compat_time += ms * 1000;
+  on_read_data(0, 8, &kb);
+}
+
+static uint32_t buttons()
+{
+  return kb.controlData.buttons;
+}
+
+// chord still completes with more combo keys held than boot report can carry,
+// including ones sorting before its own keys
+static void test_chord_many_held()
+{
+  const int low = 24; // 0x04.. are combo keys too, paired up
+
+  setup();
+  for (int i = 0; i < low / 2; i++)
+    combo(i, 0, V_SCANCODE_CROSS, SC_A + 2 * i, SC_A + 2 * i + 1);
+  combo(low / 2, 0, V_SCANCODE_PS, SC_F1, SC_F2);
+  test_activate(&b);
+  kb.buffer_size = 64;
+
+  memset(kb.buffer, 0, 64);
+  for (int i = 0; i < low; i++)
+    kb.buffer[2 + i] = SC_A + i;
+  kb.buffer[2 + low] = SC_F1;
+  compat_time += 8000;
+  on_read_data(0, 64, &kb);
+  CHECK(!(buttons() & SCE_CTRL_PSBUTTON));
+
+  kb.buffer[3 + low] = SC_F2;
+  compat_time += 8000;
+  on_read_data(0, 64, &kb);
+  CHECK(buttons() & SCE_CTRL_PSBUTTON);
+}
+
+// chord ends once any of its keys is released, keys still held send their own bindings again
+static void test_chord_release()
+{
+  setup();
+  combo(0, 0, V_SCANCODE_PS, SC_A, SC_B);
+  test_activate(&b);
+
+  report(8, 0, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_CROSS);
+  report(8, 0, SC_A, SC_B);
+  CHECK(buttons() == SCE_CTRL_PSBUTTON);
+  report(8, 0, SC_B, 0);
+  CHECK(buttons() == SCE_CTRL_CIRCLE);
+  // pressing it back isn't a new chord press of A alone
+  report(8, 0, SC_A, SC_B);
+  CHECK(buttons() == SCE_CTRL_PSBUTTON);
+  report(8, 0, 0, 0);
+  CHECK(buttons() == 0);
+}
+
+// bound modifier in chord only sends chord's binding while chord is active
+static void test_chord_modifier()
+{
+  setup();
+  combo(0, 0, V_SCANCODE_PS, SC_E, SC_LEFT_CONTROL);
+  combo(1, 0, V_SCANCODE_START, SC_Q, SC_LEFT_SHIFT);
+  b.kb_mod[KB_MOD_LEFT_CTRL]  = V_SCANCODE_TRIANGLE;
+  b.kb_mod[KB_MOD_LEFT_SHIFT] = V_SCANCODE_LXM;
+  test_activate(&b);
+
+  report(8, 1 << KB_MOD_LEFT_CTRL, 0, 0);
+  CHECK(buttons() == SCE_CTRL_TRIANGLE);
+  report(8, 1 << KB_MOD_LEFT_CTRL, SC_E, 0);
+  CHECK(buttons() == SCE_CTRL_PSBUTTON);
+  report(8, 1 << KB_MOD_LEFT_CTRL, 0, 0);
+  CHECK(buttons() == SCE_CTRL_TRIANGLE);
+
+  // axis modifiers go through processBind one by one, same masking applies
+  report(8, 1 << KB_MOD_LEFT_SHIFT, 0, 0);
+  CHECK(kb.controlData.leftX == 0);
+  report(8, 1 << KB_MOD_LEFT_SHIFT | 1 << KB_MOD_LEFT_CTRL, SC_Q, 0);
+  CHECK(buttons() == (SCE_CTRL_START | SCE_CTRL_TRIANGLE));
+  CHECK(kb.controlData.leftX == 128);
+}
+
+// sequence needs its keys in order, lasts while last one is held
+static void test_sequence_order()
+{
+  setup();
+  combo(0, 1, V_SCANCODE_L1, SC_A, SC_B);
+  test_activate(&b);
+
+  report(8, 0, SC_B, 0);
+  report(8, 0, 0, 0);
+  report(8, 0, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_CROSS);
+  report(8, 0, 0, 0);
+
+  report(8, 0, SC_B, 0);
+  CHECK(buttons() == SCE_CTRL_L1);
+  report(8, 0, SC_B, 0);
+  CHECK(buttons() == SCE_CTRL_L1);
+  report(8, 0, 0, 0);
+  CHECK(buttons() == 0);
+
+  // other key in between breaks it
+  report(8, 0, SC_A, 0);
+  report(8, 0, 0, 0);
+  report(8, 0, SC_C, 0);
+  report(8, 0, 0, 0);
+  report(8, 0, SC_B, 0);
+  CHECK(buttons() == SCE_CTRL_CIRCLE);
+}
+
+// presses further apart than window don't make a sequence
+static void test_sequence_window()
+{
+  setup();
+  combo(0, 1, V_SCANCODE_L1, SC_A, SC_B);
+  test_activate(&b);
+
+  report(8, 0, SC_A, 0);
+  report(TVIKEY_COMBO_WINDOW + 1, 0, 0, 0);
+  report(8, 0, SC_B, 0);
+  CHECK(buttons() == SCE_CTRL_CIRCLE);
+  report(8, 0, 0, 0);
+
+  report(8, 0, SC_A, 0);
+  report(TVIKEY_COMBO_WINDOW - 8, 0, SC_B, 0);
+  CHECK(buttons() == SCE_CTRL_L1);
+  report(8, 0, 0, 0);
+
+  // bindings can make it shorter
+  b.combo_window = 100;
+  test_activate(&b);
+  report(8, 0, SC_A, 0);
+  report(120, 0, SC_B, 0);
+  CHECK(buttons() == SCE_CTRL_CIRCLE);
+  report(8, 0, 0, 0);
+  report(8, 0, SC_A, 0);
+  report(80, 0, SC_B, 0);
+  CHECK(buttons() == SCE_CTRL_L1);
+}
+
+// A then B completes both chord and sequence, sequence is more deliberate and wins.
+// after a pause only chord is left
+static void test_sequence_over_chord()
+{
+  setup();
+  combo(0, 0, V_SCANCODE_PS, SC_A, SC_B);
+  combo(1, 1, V_SCANCODE_L1, SC_A, SC_B);
+  test_activate(&b);
+
+  report(8, 0, SC_A, 0);
+  report(8, 0, SC_A, SC_B);
+  CHECK(buttons() == SCE_CTRL_L1);
+  report(8, 0, 0, 0);
+
+  report(8, 0, SC_A, 0);
+  report(TVIKEY_COMBO_WINDOW + 1, 0, SC_A, SC_B);
+  CHECK(buttons() == SCE_CTRL_PSBUTTON);
+}
+
+void test_combos()
+{
+  test_chord_many_held();
+  test_chord_release();
+  test_chord_modifier();
+  test_sequence_order();
+  test_sequence_window();
+  test_sequence_over_chord();
+}
@@ -0,0 +1,109 @@
+// integer mouse curve tables against same curve in floating point
+
+#include "test.h"
+
+#include "actions.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// curves.h formula with doubles, anti-deadzone is whole stick steps like in driver
+static double reference(const bindings_t *b, int movement)
+{
+  if (!b->curve_exponent && !b->curve_anti_deadzone && !b->curve_max_speed && !b->curve_acceleration)
+    return movement + 128;
+  if (movement == 0)
+    return 128;
+
+  int full      = movement < 0 ? 128 : 127;
+  int max_speed = b->curve_max_speed ? b->curve_max_speed : full;
+  double x      = fmin(abs(movement) / (double)max_speed, 1.0);
+  double e      = b->curve_exponent ? b->curve_exponent / 256.0 : 1.0;
+
+  double y = pow(x, e);
+  y        = fmin(y * (1.0 + x * b->curve_acceleration / 100.0), 1.0);
+
+  int dz     = (b->curve_anti_deadzone > 100 ? 100 : b->curve_anti_deadzone) * full / 100;
+  double mag = dz + (full - dz) * y;
+  return movement < 0 ? 128 - mag : 128 + mag;
+}
+
+static void test_reference()
+{
+  static const uint16_t exponents[] = {0, 0x40, 0x80, 0xC0, 0x100, 0x180, 0x200, 0x300, 0x800};
+  static const uint8_t dead[]       = {0, 5, 25, 50, 100, 200};
+  static const uint8_t speeds[]     = {0, 1, 10, 40, 127, 255};
+  static const uint8_t accel[]      = {0, 25, 50, 100, 255};
+  static bindings_t b;
+  int worst = 0;
+
+  for (int e = 0; e < COUNT(exponents); e++)
+    for (int d = 0; d < COUNT(dead); d++)
+      for (int s = 0; s < COUNT(speeds); s++)
+        for (int a = 0; a < COUNT(accel); a++)
+        {
+          compiled_bindings_t c;
+          bindings_clear(&b);
+          b.curve_exponent      = exponents[e];
+          b.curve_anti_deadzone = dead[d];
+          b.curve_max_speed     = speeds[s];
+          b.curve_acceleration  = accel[a];
+          bindings_compile(&b, &c);
+
+          for (int m = -128; m < 128; m++)
+          {
+            int diff = abs(c.mouse_lut[(uint8_t)m] - (int)lround(reference(&b, m)));
+            if (diff > worst)
+              worst = diff;
+            // stick never moves back while movement grows
+            if (m > -128)
+              CHECK(c.mouse_lut[(uint8_t)m] >= c.mouse_lut[(uint8_t)(m - 1)]);
+          }
+        }
+
+  // off by one at most, from fixed point log and exp
+  CHECK(worst <= 1);
+}
+
+// no curve settings keep old movement + 128 exactly
+static void test_linear()
+{
+  static bindings_t b;
+  compiled_bindings_t c;
+
+  bindings_clear(&b);
+  bindings_compile(&b, &c);
+  for (int m = -128; m < 128; m++)
+    CHECK(c.mouse_lut[(uint8_t)m] == m + 128);
+}
+
+// exponent is uint16_t Q8.8, value that rounds past it must stay steepest curve, not wrap to linear
+static void test_exponent_parse()
+{
+  static const struct
+  {
+    const char *value;
+    uint16_t expected;
+  } cases[] = {
+      {"2.5", 0x280}, {"255.9", 0xFFE6}, {"255.9999", 0xFFFF}, {"256", 0xFFFF}, {"1000", 0xFFFF}, {"-3", 0},
+  };
+  static bindings_t b;
+
+  for (int i = 0; i < COUNT(cases); i++)
+  {
+    bindings_clear(&b);
+    CHECK(bindings_apply(&b, "MS_CURVE_EXPONENT", cases[i].value));
+    CHECK(b.curve_exponent == cases[i].expected);
+  }
+
+  bindings_clear(&b);
+  CHECK(bindings_apply(&b, "MS_SENSITIVITY_X", "-255.9999"));
+  CHECK(b.mouse_sensitivity_x == INT16_MIN);
+}
+
+void test_curves()
+{
+  test_reference();
+  test_linear();
+  test_exponent_parse();
+}
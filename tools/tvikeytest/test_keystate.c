@@ -0,0 +1,46 @@
+// key event queue of keystate.c
+
+#include "test.h"
+
+#include "keystate.h"
+
+#include <string.h>
+
+// biggest change one 64 byte report can make has to fit without drops
+static void test_full_report()
+{
+  keystate_t s;
+  uint8_t a[64], b[64];
+  key_event_t e;
+
+  memset(a, 0, sizeof(a));
+  memset(b, 0, sizeof(b));
+  a[0] = 0xFF;
+  for (int j = 2; j < 64; j++)
+  {
+    a[j] = 0x04 + j - 2;
+    b[j] = 0x80 + j - 2;
+  }
+
+  keystate_clear(&s);
+  CHECK(keystate_update(&s, a, 64) == 70);
+  while (keystate_pop(&s, &e))
+    ;
+  CHECK(keystate_update(&s, b, 64) == 132);
+  CHECK(s.dropped == 0);
+
+  int pressed = 0, released = 0;
+  while (keystate_pop(&s, &e))
+  {
+    if (e.pressed)
+      pressed++;
+    else
+      released++;
+  }
+  CHECK(pressed == 62 && released == 70);
+}
+
+void test_keystate()
+{
+  test_full_report();
+}
@@ -0,0 +1,137 @@
+// keyboard layers from report sequences, through on_read_data like usb callback would
+
+#include "test.h"
+
+#include "inputdevice.h"
+#include "scancodes/scancodes.h"
+
+#include <psp2kern/ctrl.h>
+#include <string.h>
+
+void on_read_data(int32_t result, int32_t count, void *arg);
+
+static InputDevice kb;
+
+// boot report with modifier byte and up to 2 keys
+static void report(uint8_t mods, uint8_t key1, uint8_t key2)
+{
+  memset(kb.buffer, 0, 8);
+  kb.buffer[0] = mods;
+  kb.buffer[2] = key1;
+  kb.buffer[3] = key2;
+  compat_time += 8000;
+  on_read_data(0, 8, &kb);
+}
+
+static uint32_t buttons()
+{
+  return kb.controlData.buttons;
+}
+
+static void setup()
+{
+  static bindings_t b;
+  bindings_clear(&b);
+  b.kb[SC_A]        = V_SCANCODE_CROSS;
+  b.kb[SC_B]        = V_SCANCODE_L1;
+  b.layers[0][SC_A] = V_SCANCODE_CIRCLE;
+  b.layers[1][SC_A] = V_SCANCODE_SQUARE;
+  b.layer_hold[0]   = SC_LEFT_CONTROL;
+  b.layer_toggle[1] = SC_F1;
+  test_activate(&b);
+
+  memset(&kb, 0, sizeof(kb));
+  kb.type        = KEYBOARD;
+  kb.inited      = 1;
+  kb.buffer_size = 8;
+  keystate_clear(&kb.keys);
+  combo_reset(&kb.combo);
+}
+
+static void test_hold()
+{
+  setup();
+  report(0, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_CROSS);
+  report(1 << KB_MOD_LEFT_CTRL, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_CIRCLE);
+  // unbound in layer falls through to base
+  report(1 << KB_MOD_LEFT_CTRL, SC_A, SC_B);
+  CHECK(buttons() == (SCE_CTRL_CIRCLE | SCE_CTRL_L1));
+  report(0, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_CROSS);
+  CHECK(kb.layer_toggled == 0);
+}
+
+static void test_toggle()
+{
+  setup();
+  report(0, SC_F1, 0);
+  report(0, 0, 0);
+  report(0, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_SQUARE);
+  // holding toggle key doesn't flip it again
+  report(0, SC_A, SC_F1);
+  report(0, SC_A, SC_F1);
+  CHECK(buttons() == SCE_CTRL_CROSS);
+  report(0, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_CROSS);
+  report(0, SC_A, SC_F1);
+  CHECK(buttons() == SCE_CTRL_SQUARE);
+}
+
+static void test_hold_over_toggle()
+{
+  setup();
+  report(0, SC_F1, 0);
+  report(0, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_SQUARE);
+  report(1 << KB_MOD_LEFT_CTRL, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_CIRCLE);
+  // toggled layer is still there once hold ends
+  report(0, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_SQUARE);
+}
+
+// app exiting resets layers, same report afterwards has to be decoded again on base layer
+static void test_reset()
+{
+  setup();
+  report(0, SC_F1, 0);
+  report(0, SC_A, 0);
+  CHECK(buttons() == SCE_CTRL_SQUARE);
+
+  usb_reset_layers(&kb);
+  kb.controlData.buttons = 0;
+  report(0, SC_A, 0);
+  CHECK(kb.layer_toggled == 0);
+  CHECK(buttons() == SCE_CTRL_CROSS);
+}
+
+// bytes past short report are left from longer one before, they aren't keys any more
+static void test_short_report()
+{
+  setup();
+  kb.buffer_size = 16;
+  memset(kb.buffer, 0, 16);
+  kb.buffer[8] = SC_A;
+  kb.buffer[9] = SC_F1;
+  compat_time += 8000;
+  on_read_data(0, 16, &kb);
+  CHECK(buttons() == SCE_CTRL_SQUARE);
+
+  kb.buffer[2] = SC_B;
+  compat_time += 8000;
+  on_read_data(0, 8, &kb);
+  CHECK(buttons() == SCE_CTRL_L1);
+  CHECK(kb.layer_toggled == 2);
+}
+
+void test_layers()
+{
+  test_hold();
+  test_toggle();
+  test_hold_over_toggle();
+  test_reset();
+  test_short_report();
+}
@@ -0,0 +1,268 @@
+// action lists next to single targets, which have to work exactly as before lists existed
+
+#include "test.h"
+
+#include "devices/process_bind.h"
+#include "scancodes/scancodes.h"
+
+#include <psp2kern/ctrl.h>
+#include <string.h>
+
+static const struct
+{
+  int code;
+  const char *name;
+} vita[] = {
+    {V_SCANCODE_DUP, "DPAD_UP"},
+    {V_SCANCODE_DDOWN, "DPAD_DOWN"},
+    {V_SCANCODE_DLEFT, "DPAD_LEFT"},
+    {V_SCANCODE_DRIGHT, "DPAD_RIGHT"},
+    {V_SCANCODE_CROSS, "CROSS"},
+    {V_SCANCODE_SQUARE, "SQUARE"},
+    {V_SCANCODE_TRIANGLE, "TRIANGLE"},
+    {V_SCANCODE_CIRCLE, "CIRCLE"},
+    {V_SCANCODE_SELECT, "SELECT"},
+    {V_SCANCODE_START, "START"},
+    {V_SCANCODE_PS, "PS"},
+    {V_SCANCODE_L1, "L1"},
+    {V_SCANCODE_L2, "L2"},
+    {V_SCANCODE_L3, "L3"},
+    {V_SCANCODE_R1, "R1"},
+    {V_SCANCODE_R2, "R2"},
+    {V_SCANCODE_R3, "R3"},
+    {V_SCANCODE_LXM, "LEFT_ANALOG_LEFT"},
+    {V_SCANCODE_LXP, "LEFT_ANALOG_RIGHT"},
+    {V_SCANCODE_LYP, "LEFT_ANALOG_DOWN"},
+    {V_SCANCODE_LYM, "LEFT_ANALOG_UP"},
+    {V_SCANCODE_RXM, "RIGHT_ANALOG_LEFT"},
+    {V_SCANCODE_RXP, "RIGHT_ANALOG_RIGHT"},
+    {V_SCANCODE_RYP, "RIGHT_ANALOG_DOWN"},
+    {V_SCANCODE_RYM, "RIGHT_ANALOG_UP"},
+};
+
+// processBind of the driver before actions[] and lists, switch over every vita input
+static void old_bind(ControlData *d, uint8_t bind)
+{
+  switch (bind)
+  {
+    case V_SCANCODE_DUP:
+      d->buttons |= SCE_CTRL_UP;
+      break;
+    case V_SCANCODE_DDOWN:
+      d->buttons |= SCE_CTRL_DOWN;
+      break;
+    case V_SCANCODE_DLEFT:
+      d->buttons |= SCE_CTRL_LEFT;
+      break;
+    case V_SCANCODE_DRIGHT:
+      d->buttons |= SCE_CTRL_RIGHT;
+      break;
+    case V_SCANCODE_CROSS:
+      d->buttons |= SCE_CTRL_CROSS;
+      break;
+    case V_SCANCODE_CIRCLE:
+      d->buttons |= SCE_CTRL_CIRCLE;
+      break;
+    case V_SCANCODE_TRIANGLE:
+      d->buttons |= SCE_CTRL_TRIANGLE;
+      break;
+    case V_SCANCODE_SQUARE:
+      d->buttons |= SCE_CTRL_SQUARE;
+      break;
+    case V_SCANCODE_L1:
+      d->buttons |= SCE_CTRL_L1;
+      break;
+    case V_SCANCODE_R1:
+      d->buttons |= SCE_CTRL_R1;
+      break;
+    case V_SCANCODE_L3:
+      d->buttons |= SCE_CTRL_L3;
+      break;
+    case V_SCANCODE_R3:
+      d->buttons |= SCE_CTRL_R3;
+      break;
+    case V_SCANCODE_L2:
+      d->buttons |= SCE_CTRL_LTRIGGER;
+      d->lt = 0xFF;
+      break;
+    case V_SCANCODE_R2:
+      d->buttons |= SCE_CTRL_RTRIGGER;
+      d->rt = 0xFF;
+      break;
+    case V_SCANCODE_LXM:
+      d->leftX = 0;
+      break;
+    case V_SCANCODE_LXP:
+      d->leftX = 255;
+      break;
+    case V_SCANCODE_LYM:
+      d->leftY = 0;
+      break;
+    case V_SCANCODE_LYP:
+      d->leftY = 255;
+      break;
+    case V_SCANCODE_RXM:
+      d->rightX = 0;
+      break;
+    case V_SCANCODE_RXP:
+      d->rightX = 255;
+      break;
+    case V_SCANCODE_RYM:
+      d->rightY = 0;
+      break;
+    case V_SCANCODE_RYP:
+      d->rightY = 255;
+      break;
+    case V_SCANCODE_PS:
+      d->buttons |= SCE_CTRL_PSBUTTON;
+      break;
+    case V_SCANCODE_START:
+      d->buttons |= SCE_CTRL_START;
+      break;
+    case V_SCANCODE_SELECT:
+      d->buttons |= SCE_CTRL_SELECT;
+      break;
+  }
+}
+
+// analog version only moved axes and triggers
+static void old_analog_bind(ControlData *d, uint8_t bind, uint8_t value)
+{
+  switch (bind)
+  {
+    case V_SCANCODE_L2:
+      d->buttons |= SCE_CTRL_LTRIGGER;
+      d->lt = value;
+      break;
+    case V_SCANCODE_R2:
+      d->buttons |= SCE_CTRL_RTRIGGER;
+      d->rt = value;
+      break;
+    case V_SCANCODE_LXM:
+    case V_SCANCODE_LXP:
+      d->leftX = value;
+      break;
+    case V_SCANCODE_LYM:
+    case V_SCANCODE_LYP:
+      d->leftY = value;
+      break;
+    case V_SCANCODE_RXM:
+    case V_SCANCODE_RXP:
+      d->rightX = value;
+      break;
+    case V_SCANCODE_RYM:
+    case V_SCANCODE_RYP:
+      d->rightY = value;
+      break;
+  }
+}
+
+static void neutral(ControlData *d)
+{
+  memset(d, 0, sizeof(ControlData));
+  d->leftX = d->leftY = d->rightX = d->rightY = 128;
+}
+
+static int same(const ControlData *a, const ControlData *b)
+{
+  return a->buttons == b->buttons && a->leftX == b->leftX && a->leftY == b->leftY && a->rightX == b->rightX
+         && a->rightY == b->rightY && a->lt == b->lt && a->rt == b->rt;
+}
+
+// every value without list bit, bound or not, does what old switch did
+static void test_single_actions()
+{
+  static bindings_t b;
+  bindings_clear(&b);
+
+  for (int v = 0; v < TVIKEY_LIST; v++)
+  {
+    ControlData now, old;
+    neutral(&now);
+    neutral(&old);
+    processBind(&now, &b, v);
+    old_bind(&old, v);
+    CHECK(same(&now, &old));
+
+    // analog binds of buttons are buttons too now, old one ignored them
+    neutral(&now);
+    neutral(&old);
+    processAnalogBind(&now, &b, v, 77);
+    old_analog_bind(&old, v, 77);
+    if (actions[v].axis != AXIS_NONE)
+      CHECK(same(&now, &old));
+  }
+}
+
+// single targets are stored as plain scancodes and never touch lists, whatever is there already
+static void test_single_parse()
+{
+  static bindings_t b, lists;
+
+  bindings_clear(&lists);
+  CHECK(bindings_apply(&lists, "KB_Q", "L2 + R1"));
+  CHECK(bindings_apply(&lists, "KB_E", "CROSS + CIRCLE + SQUARE"));
+
+  for (int i = 0; i < COUNT(vita); i++)
+  {
+    bindings_clear(&b);
+    CHECK(bindings_apply(&b, "KB_A", vita[i].name));
+    CHECK(bindings_apply(&b, "KB_LEFT_SHIFT", vita[i].name));
+    CHECK(bindings_apply(&b, "MOUSE_1", vita[i].name));
+    CHECK(b.kb[SC_A] == vita[i].code && b.kb_mod[KB_MOD_LEFT_SHIFT] == vita[i].code
+          && b.mouse[MS_SCANCODE_1] == vita[i].code);
+    for (unsigned int j = 0; j < sizeof(b.lists); j++)
+      CHECK(b.lists[j] == 0);
+
+    memcpy(&b, &lists, sizeof(b));
+    CHECK(bindings_apply(&b, "KB_A", vita[i].name));
+    CHECK(b.kb[SC_A] == vita[i].code);
+    CHECK(memcmp(b.lists, lists.lists, sizeof(b.lists)) == 0);
+    CHECK(bindings_validate(&b));
+  }
+
+  // same input twice in list isn't single target
+  bindings_clear(&b);
+  CHECK(bindings_apply(&b, "KB_A", "CROSS + CROSS"));
+  CHECK(b.kb[SC_A] & TVIKEY_LIST);
+}
+
+static void test_list_dedupe()
+{
+  static bindings_t b;
+
+  bindings_clear(&b);
+  CHECK(bindings_apply(&b, "KB_Q", "L2 + R1"));
+  CHECK(bindings_apply(&b, "KB_E", "L2 + R1"));
+  CHECK(b.kb[SC_Q] == b.kb[SC_E]);
+  // tail of existing list isn't list of its own
+  CHECK(bindings_apply(&b, "KB_R", "R1"));
+  CHECK(bindings_apply(&b, "KB_T", "CROSS + L2 + R1"));
+  CHECK(b.kb[SC_T] != b.kb[SC_Q]);
+  CHECK(bindings_validate(&b));
+
+  // lists full up to the last byte, with what follows them in struct looking like rest of a list:
+  // candidate at the last byte must not be compared past the end
+  bindings_clear(&b);
+  memset(b.lists, V_SCANCODE_CROSS, sizeof(b.lists));
+  b.lists[sizeof(b.lists) - 2] = 0;
+  b.layers[0][0]               = V_SCANCODE_CIRCLE;
+  CHECK(!bindings_apply(&b, "KB_Q", "CROSS + CIRCLE"));
+  CHECK(b.kb[SC_Q] == 0);
+
+  // new list that ends at the last byte is still found again, next one doesn't fit
+  bindings_clear(&b);
+  memset(b.lists, V_SCANCODE_CROSS, sizeof(b.lists) - 4);
+  CHECK(bindings_apply(&b, "KB_Q", "L1 + R1"));
+  CHECK(b.kb[SC_Q] == (TVIKEY_LIST | (sizeof(b.lists) - 3)));
+  CHECK(bindings_apply(&b, "KB_E", "L1 + R1"));
+  CHECK(b.kb[SC_E] == b.kb[SC_Q]);
+  CHECK(!bindings_apply(&b, "KB_R", "L2 + R2"));
+}
+
+void test_lists()
+{
+  test_single_actions();
+  test_single_parse();
+  test_list_dedupe();
+}
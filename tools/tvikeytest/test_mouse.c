@@ -0,0 +1,133 @@
+// mouse movement from reports to stick, through on_read_data and Mouse_applyMotion
+
+#include "test.h"
+
+#include "devices/mouse.h"
+#include "scancodes/scancodes.h"
+
+#include <string.h>
+
+void on_read_data(int32_t result, int32_t count, void *arg);
+
+static InputDevice mouse;
+
+static void setup(int16_t sensitivity)
+{
+  static bindings_t b;
+  bindings_clear(&b);
+  b.mouse_sensitivity_x    = sensitivity;
+  b.mouse_sensitivity_y    = sensitivity;
+  b.mouse[MS_SCANCODE_XM]  = V_SCANCODE_RXM;
+  b.mouse[MS_SCANCODE_XP]  = V_SCANCODE_RXP;
+  test_activate(&b);
+
+  memset(&mouse, 0, sizeof(mouse));
+  mouse.type        = MOUSE;
+  mouse.inited      = 1;
+  mouse.buffer_size = 4;
+  mouse.motion_time = compat_time;
+  mouse.report_time = compat_time;
+  mouse.delta_time  = compat_time;
+}
+
+// dx every report_us, controller read every read_us, returns sum of stick movement over reads
+static int drag(int dx, int report_us, int read_us, int reads)
+{
+  int sum = 0;
+  for (int t = 1; t <= reads * read_us; t++)
+  {
+    compat_time++;
+    if (t % report_us == 0)
+    {
+      memset(mouse.buffer, 0, 4);
+      mouse.buffer[1] = (uint8_t)dx;
+      on_read_data(0, 4, &mouse);
+    }
+    if (t % read_us == 0)
+    {
+      ControlData d;
+      memset(&d, 0, sizeof(d));
+      Mouse_applyMotion(&mouse, &d);
+      sum += (int8_t)(mouse.motion & 0xFF);
+    }
+  }
+  return sum;
+}
+
+// Movement far below one stick step per read has to come out eventually, in full.
+// Reads every 16 ms take twice reference time, so each gets half of delta * sensitivity.
+static void test_slow_drag()
+{
+  static const struct
+  {
+    int dx;
+    int report_us;
+    int16_t sensitivity; // Q8.8
+  } cases[] = {
+      {1, 8000, 77},   // 125 Hz mouse at 0.3: 0.3 step per read
+      {-1, 8000, 77},  // same to the left
+      {1, 1000, 13},   // 1000 Hz mouse at 0.05: 0.41 step per read
+      {1, 8000, 1},    // smallest sensitivity there is
+      {-1, 1000, 3},
+  };
+  const int reads = 2000;
+
+  for (int i = 0; i < COUNT(cases); i++)
+  {
+    setup(cases[i].sensitivity);
+    int per_read = 16000 / cases[i].report_us * cases[i].sensitivity / 2; // Q8
+    int expected = reads * per_read / 256;
+
+    int sum = drag(cases[i].dx, cases[i].report_us, 16000, reads);
+    CHECK(expected > 0);
+    CHECK(sum == cases[i].dx * expected);
+    // what's left is in carry, less than one step
+    CHECK(mouse.mouse_carry[0] == cases[i].dx * (reads * per_read % 256));
+  }
+}
+
+// First read after idle sees burst over time since its first report, not over whole gap.
+static void test_idle_gap()
+{
+  static const struct
+  {
+    SceUInt64 gap; // 0 for device that never had read, motion_time 0
+    int reports;
+    int report_us;
+    int dx;
+    int expected;
+  } cases[] = {
+      {10000000, 1, 0, 20, 20},               // single report counts as one at 125 Hz
+      {MOTION_REFERENCE << 8, 1, 0, 20, 20},  // where ratio used to bottom out
+      {0, 1, 0, 20, 20},                      // first read ever
+      {10000000, 8, 1000, 5, 40 * 136 / 256}, // 1000 Hz burst over 7 ms + reference
+      {10000000, 10, 0, 127, 127},            // big burst is full deflection, not dropped
+  };
+
+  for (int i = 0; i < COUNT(cases); i++)
+  {
+    setup(256);
+    mouse.motion_time = cases[i].gap ? compat_time : 0;
+    compat_time += cases[i].gap ? cases[i].gap : 5000000;
+
+    for (int r = 0; r < cases[i].reports; r++)
+    {
+      if (r)
+        compat_time += cases[i].report_us;
+      memset(mouse.buffer, 0, 4);
+      mouse.buffer[1] = (uint8_t)cases[i].dx;
+      on_read_data(0, 4, &mouse);
+    }
+
+    ControlData d;
+    memset(&d, 0, sizeof(d));
+    Mouse_applyMotion(&mouse, &d);
+    CHECK((int8_t)(mouse.motion & 0xFF) == cases[i].expected);
+  }
+}
+
+void test_mouse()
+{
+  test_slow_drag();
+  test_idle_gap();
+}
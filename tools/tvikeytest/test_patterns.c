@@ -0,0 +1,133 @@
+// section patterns: "most specific wins" in trie, ini_index and tvikey.bin
+//
+// Rule from trie.h: more literal characters first, then pattern without '*', then first in ini.
+// Exact section beats any pattern.
+
+#include "test.h"
+
+#include "../tvikeyc/compile.h"
+#include "binconfig.h"
+#include "ini_index.h"
+#include "scancodes/scancodes.h"
+#include "util/trie.h"
+
+#include <string.h>
+
+#define INI_FILE "data/tvikey.ini"
+#define BIN_FILE "data/tvikey.bin"
+#define INI_TIME 1710000000L
+
+static const struct
+{
+  const char *section;
+  const char *bind;
+} sections[] = {
+    {"PCSE0000*", "DPAD_UP"},  {"PCSE0000?", "CROSS"}, {"PCS?00001", "CIRCLE"}, {"PCSE1234*", "SQUARE"},
+    {"PCSE123??", "TRIANGLE"}, {"PCS*", "L1"},         {"*", "R1"},             {"PCSE00003", "START"},
+    {"PCSE0000?", "SELECT"}, // duplicate, first one is kept
+};
+
+static const struct
+{
+  const char *titleid;
+  const char *section;
+  uint8_t bind;
+} titles[] = {
+    {"PCSE00001", "PCSE0000?", V_SCANCODE_CROSS},    // tie with PCS?00001, earlier one wins
+    {"PCSF00001", "PCS?00001", V_SCANCODE_CIRCLE},   // more literals than PCS*
+    {"PCSE00002", "PCSE0000?", V_SCANCODE_CROSS},    // same literals, '?' beats '*' listed before it
+    {"PCSE000012", "PCSE0000*", V_SCANCODE_DUP},     // '?' is exactly one character
+    {"PCSE12345", "PCSE1234*", V_SCANCODE_SQUARE},   // more literals beat full match
+    {"PCSE12399", "PCSE123??", V_SCANCODE_TRIANGLE},
+    {"PCSG12345", "PCS*", V_SCANCODE_L1},
+    {"NPXS10000", "*", V_SCANCODE_R1},
+    {"PCSE00003", "PCSE00003", V_SCANCODE_START},    // exact after all patterns still wins
+};
+
+// best pattern by the rule, one at a time with trie_match
+static int reference(const char *name)
+{
+  int best = -1, best_score = -1;
+  for (int i = 0; i < COUNT(sections); i++)
+  {
+    int score = trie_match(sections[i].section, name);
+    if (trie_is_pattern(sections[i].section) == 1 && score > best_score)
+    {
+      best       = i;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+static void test_trie()
+{
+  static trie_node_t nodes[128];
+  trie_t t;
+
+  trie_init(&t, nodes, COUNT(nodes));
+  for (int i = 0; i < COUNT(sections); i++)
+  {
+    if (trie_is_pattern(sections[i].section) == 1)
+      CHECK(trie_insert(&t, sections[i].section, i) == (i == COUNT(sections) - 1 ? 1 : 0));
+  }
+
+  static const char *names[] = {"PCSE00001", "PCSF00001", "PCSE00002", "PCSE000012", "PCSE12345", "PCSE12399",
+                                "PCSG12345", "NPXS10000", "PCSE00003", "PCSE0000",   "PCS",       ""};
+  for (int i = 0; i < COUNT(names); i++)
+    CHECK(trie_find(&t, names[i]) == reference(names[i]));
+
+  // '*' matches empty rest, '?' doesn't
+  trie_init(&t, nodes, COUNT(nodes));
+  CHECK(trie_insert(&t, "PCSE0000?", 0) == 0);
+  CHECK(trie_insert(&t, "PCSE00001*", 1) == 0);
+  CHECK(trie_find(&t, "PCSE00001") == 1);
+  CHECK(trie_find(&t, "PCSE0000") == -1);
+}
+
+static void write_ini()
+{
+  static char ini[1024];
+  int len = 0;
+  for (int i = 0; i < COUNT(sections); i++)
+    len += snprintf(ini + len, sizeof(ini) - len, "[%s]\nKB_A = %s\n\n", sections[i].section, sections[i].bind);
+  test_write(INI_FILE, ini);
+  test_touch(INI_FILE, INI_TIME);
+}
+
+static void test_ini_index()
+{
+  write_ini();
+
+  for (int i = 0; i < COUNT(titles); i++)
+  {
+    char section[16];
+    unsigned int offset;
+    CHECK(ini_index_find(titles[i].titleid, section, &offset) == 1);
+    CHECK(strcmp(section, titles[i].section) == 0);
+  }
+}
+
+static void test_bin()
+{
+  static bindings_t b;
+  compile_stats_t stats;
+
+  write_ini();
+  CHECK(compile_ini(INI_FILE, BIN_FILE, &stats));
+  test_touch(BIN_FILE, INI_TIME + 100);
+
+  for (int i = 0; i < COUNT(titles); i++)
+  {
+    bindings_clear(&b);
+    CHECK(binconfig_load(titles[i].titleid, &b) == 1);
+    CHECK(b.kb[SC_A] == titles[i].bind);
+  }
+}
+
+void test_patterns()
+{
+  test_trie();
+  test_ini_index();
+  test_bin();
+}
@@ -0,0 +1,97 @@
+// tvikeytest - host unit tests of driver code that doesn't need the vita
+//
+// usage: tvikeytest
+//
+// Sources from src/ are compiled as they are, kernel calls they make come from compat/.
+// Prints failed checks and exits with 1 if there were any.
+
+#include "test.h"
+
+#include "arena.h"
+#include "profile.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+int test_failures;
+SceUInt64 compat_time = 1000000;
+
+void test_activate(const bindings_t *b)
+{
+  profile_t *p = profile_intern(b);
+  if (!p)
+  {
+    fprintf(stderr, "error: profile pool exhausted\n");
+    exit(1);
+  }
+  profile_activate(p);
+  profile_unref(p);
+}
+
+void test_write(const char *path, const char *text)
+{
+  FILE *f = fopen(path, "wb");
+  if (!f || fwrite(text, 1, strlen(text), f) != strlen(text) || fclose(f) != 0)
+  {
+    perror(path);
+    exit(1);
+  }
+}
+
+void test_touch(const char *path, long mtime)
+{
+  struct timeval t[2] = {{mtime, 0}, {mtime, 0}};
+  if (utimes(path, t) != 0)
+  {
+    perror(path);
+    exit(1);
+  }
+}
+
+static const struct
+{
+  const char *name;
+  void (*run)();
+} tests[] = {
+    {"binconfig", test_binconfig},
+    {"bindings", test_bindings},
+    {"combos", test_combos},
+    {"curves", test_curves},
+    {"keystate", test_keystate},
+    {"layers", test_layers},
+    {"lists", test_lists},
+    {"mouse", test_mouse},
+    {"patterns", test_patterns},
+};
+
+int main(int argc, char *argv[])
+{
+  if (arena_init() < 0 || profile_init() < 0)
+  {
+    fprintf(stderr, "error: can't set up profile pool\n");
+    return 1;
+  }
+
+  char dir[] = "/tmp/tvikeytest.XXXXXX";
+  if (!mkdtemp(dir) || chdir(dir) != 0 || mkdir("data", 0700) != 0)
+  {
+    perror(dir);
+    return 1;
+  }
+
+  for (int i = 0; i < COUNT(tests); i++)
+  {
+    int before = test_failures;
+    tests[i].run();
+    printf("%-12s %s\n", tests[i].name, test_failures == before ? "ok" : "FAILED");
+  }
+
+  unlink("data/tvikey.ini");
+  unlink("data/tvikey.bin");
+  rmdir("data");
+  rmdir(dir);
+  return test_failures != 0;
+}